@@ -18,9 +18,21 @@ y=0
 #maximum bound in of all objects in any direction (or minimum distance between two rows)
 maxbound = 0
 
+#set decimation parameters, 0 disables the respective bound, all 0 imports the meshes unchanged <------ Raise these for dense objects that exceed Max Particles
+#maximum number of vertices per object
+target_vertices = 0
+#maximum number of triangles per object
+target_triangles = 0
+#maximum mean squared distance (in cm^2) of a merged vertex to the planes of the original triangles it replaces, 0 disables it
+max_error = 0.0
+#folder for the mappings between decimated and original vertices, starts from DatabaseGeneration project folder as root
+decimation_map_directory = "DecimationMaps"
+#sort vertices, triangles and Flex clusters along a Morton curve, so skinning and storing run through memory in order, the original orders are stored as .vertexorder and .clusterorder in decimation_map_directory
+reorder_vertices = False
+
 
 #import assets
-unreal.MyBlueprintFunctionLibrary.import_assets(input_directory, output_directory)
+unreal.MyBlueprintFunctionLibrary.import_assets(input_directory, output_directory, target_vertices, target_triangles, max_error, decimation_map_directory, reorder_vertices)
 AssetRegistry = unreal.AssetRegistryHelpers.get_asset_registry()
 #get imported flex assets
 assets=AssetRegistry.get_assets_by_path(unreal.StringLibrary.concat_str_str(output_directory,"/Flex"))
@@ -44,6 +56,9 @@ for i,ass in enumerate(assets):
     asset.get_editor_property('FlexAsset').set_editor_property('ContainerTemplate',unreal.load_asset(unreal.World(),"/Game/ProjectContent/Flex/FlexContainerSoft.FlexContainerSoft"))
     #apply changes
     unreal.MyBlueprintFunctionLibrary.apply_changes(asset)
+    #applying rebuilds the clusters in Flex order, so sort them afterwards
+    if reorder_vertices:
+        unreal.MyBlueprintFunctionLibrary.reorder_flex_clusters(asset, decimation_map_directory)
     
 
 
@@ -0,0 +1,114 @@
+#Code by Marvin Kinz, m.kinz@stud.uni-heidelberg.de
+
+#Reads the snapshots published by OpenSnapshotRing/PublishSnapshot/PublishObject of MyBlueprintFunctionLibrary from shared memory.
+#Run this with your normal Python next to the Unreal Editor, NOT with "File->Execute Python Script". The memory layout is described in SnapshotRing.h.
+
+import mmap
+import os
+import struct
+import sys
+import time
+
+import numpy as np
+
+#header: magic, version, number of slots, reserved, slot size, number of published snapshots
+HEADER = struct.Struct("<4sIIIQQ")
+HEADER_SIZE = 64
+#slot header: sequence, number of vertices, number of normals, number of triangle indices, kind, frame, time, label
+SLOT = struct.Struct("<QIIIIQd216s")
+MAGIC = b"FXSR"
+VERSION = 2
+#kinds of snapshots, see ESnapshotKind
+MESH = 0
+OBJECT = 1
+
+
+class SnapshotRing:
+    def __init__(self, name="DatabaseGenerationSnapshots"):
+        if os.name == "nt":
+            #named file mapping in the session namespace, map the header first to get the size of the whole ring
+            name = "Local\\" + name
+            header = mmap.mmap(-1, HEADER_SIZE, tagname=name)
+            magic, version, self.num_slots, _, self.slot_size, _ = HEADER.unpack_from(header, 0)
+            header.close()
+            self._map = mmap.mmap(-1, HEADER_SIZE + self.num_slots * self.slot_size, tagname=name)
+        else:
+            #POSIX shared memory object, FPlatformMemory creates it as "/" + name
+            with open("/dev/shm/" + name, "rb") as file:
+                self._map = mmap.mmap(file.fileno(), 0, access=mmap.ACCESS_READ)
+            magic, version, self.num_slots, _, self.slot_size, _ = HEADER.unpack_from(self._map, 0)
+        if magic != MAGIC or version != VERSION:
+            raise RuntimeError(name + " is no snapshot ring of version " + str(VERSION))
+
+    def published(self):
+        """Number of snapshots published so far"""
+        return struct.unpack_from("<Q", self._map, 24)[0]
+
+    def read(self, index):
+        """Returns (label, kind, frame, time, positions, normals, triangles) of snapshot index or None, if it has not been published yet or has already been overwritten"""
+        offset = HEADER_SIZE + (index % self.num_slots) * self.slot_size
+        expected = 2 * index + 2
+        sequence, num_vertices, num_normals, num_triangle_indices, kind, frame, time, label = SLOT.unpack_from(self._map, offset)
+        if sequence != expected or SLOT.size + (num_vertices * 3 + num_normals * 3 + num_triangle_indices) * 4 > self.slot_size:
+            return None
+        payload = offset + SLOT.size
+        positions = np.frombuffer(self._map, np.float32, num_vertices * 3, payload).reshape(-1, 3).copy()
+        payload += num_vertices * 12
+        normals = np.frombuffer(self._map, np.float32, num_normals * 3, payload).reshape(-1, 3).copy()
+        payload += num_normals * 12
+        triangles = np.frombuffer(self._map, np.int32, num_triangle_indices, payload).reshape(-1, 3).copy()
+        #slot must not have been reused while copying
+        if struct.unpack_from("<Q", self._map, offset)[0] != expected:
+            return None
+        return label.split(b"\0", 1)[0].decode("utf-8"), kind, frame, time, positions, normals, triangles
+
+    def close(self):
+        self._map.close()
+
+
+def write_text(path, data, fmt):
+    """Writes data like the Editor does, the file is opened in binary mode so os.linesep is not translated a second time on Windows"""
+    with open(path, "wb") as file:
+        np.savetxt(file, data, fmt=fmt, newline=os.linesep)
+
+
+def persist(project_directory, name="DatabaseGenerationSnapshots", poll_interval=0.01):
+    """
+    Persistence consumer: writes every snapshot to project_directory/label in the format the Editor would have written it,
+    objects as one .xyz with position and normal per line like SaveObject, meshes as .xyz, .normals and .triangle like the Write ... Data Into File functions.
+    Runs until interrupted with Ctrl+C.
+    """
+    ring = SnapshotRing(name)
+    #start with the oldest snapshot still in the ring
+    next_index = max(0, ring.published() - ring.num_slots)
+    try:
+        while True:
+            published = ring.published()
+            while next_index < published:
+                snapshot = ring.read(next_index)
+                if snapshot is None:
+                    print("Snapshot", next_index, "has been overwritten before it could be stored, raise the number of slots.")
+                else:
+                    label, kind, _, _, positions, normals, triangles = snapshot
+                    path = os.path.join(project_directory, label)
+                    os.makedirs(os.path.dirname(path), exist_ok=True)
+                    if kind == OBJECT:
+                        write_text(path + ".xyz", np.hstack((positions, normals)), fmt="%f")
+                    else:
+                        if len(positions):
+                            write_text(path + ".xyz", positions, fmt="%f")
+                        if len(normals):
+                            write_text(path + ".normals", normals, fmt="%f")
+                        if len(triangles):
+                            write_text(path + ".triangle", triangles, fmt="%d")
+                next_index += 1
+            time.sleep(poll_interval)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        ring.close()
+
+
+if __name__ == "__main__":
+    #path of the DatabaseGeneration project folder, labels are relative to it like the output folders
+    persist(sys.argv[1] if len(sys.argv) > 1 else ".")
@@ -0,0 +1,144 @@
+// Code by Marvin Kinz, m.kinz@stud.uni-heidelberg.de
+
+#include "FlexCheckpoint.h"
+#include <cstring>
+
+namespace
+{
+	const char CheckpointMagic[4] = { 'F', 'X', 'C', 'P' };
+	const uint32_t CheckpointVersion = 1;
+
+	void WriteBytes(std::vector<uint8_t>& Blob, const void* Data, size_t Size)
+	{
+		const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+		Blob.insert(Blob.end(), Bytes, Bytes + Size);
+	}
+
+	void WriteUInt(std::vector<uint8_t>& Blob, uint32_t Value)
+	{
+		WriteBytes(Blob, &Value, sizeof(Value));
+	}
+
+	void WriteFloats(std::vector<uint8_t>& Blob, const std::vector<float>& Values)
+	{
+		if (!Values.empty())
+		{
+			WriteBytes(Blob, Values.data(), Values.size() * sizeof(float));
+		}
+	}
+
+	//Reads from a blob and remembers, whether it ran out of data
+	struct FBlobReader
+	{
+		const uint8_t* Data;
+		size_t Size;
+		size_t Offset = 0;
+
+		FBlobReader(const uint8_t* InData, size_t InSize) : Data(InData), Size(InSize) {}
+
+		bool ReadBytes(void* Out, size_t Count)
+		{
+			if (Count > Size - Offset)
+			{
+				return false;
+			}
+			if (Count > 0)
+			{
+				std::memcpy(Out, Data + Offset, Count);
+			}
+			Offset += Count;
+			return true;
+		}
+
+		bool ReadUInt(uint32_t& Out)
+		{
+			return ReadBytes(&Out, sizeof(Out));
+		}
+
+		bool ReadFloats(std::vector<float>& Out, size_t Count)
+		{
+			//Check before resizing, so a corrupted count can not allocate huge arrays
+			if (Count > (Size - Offset) / sizeof(float))
+			{
+				return false;
+			}
+			Out.resize(Count);
+			return ReadBytes(Out.data(), Count * sizeof(float));
+		}
+	};
+}
+
+const FFlexCheckpointComponent* FFlexCheckpoint::Find(const std::string& Name) const
+{
+	for (const FFlexCheckpointComponent& Component : Components)
+	{
+		if (Component.Name == Name)
+		{
+			return &Component;
+		}
+	}
+	return nullptr;
+}
+
+std::vector<uint8_t> SerializeFlexCheckpoint(const FFlexCheckpoint& Checkpoint)
+{
+	std::vector<uint8_t> Blob;
+	WriteBytes(Blob, CheckpointMagic, sizeof(CheckpointMagic));
+	WriteUInt(Blob, CheckpointVersion);
+	WriteUInt(Blob, static_cast<uint32_t>(Checkpoint.Components.size()));
+	for (const FFlexCheckpointComponent& Component : Checkpoint.Components)
+	{
+		WriteUInt(Blob, static_cast<uint32_t>(Component.Name.size()));
+		WriteBytes(Blob, Component.Name.data(), Component.Name.size());
+		//Counts instead of array lengths, the reader derives the lengths from them
+		WriteUInt(Blob, static_cast<uint32_t>(Component.Particles.size() / 4));
+		WriteUInt(Blob, static_cast<uint32_t>(Component.ShapeRotations.size() / 4));
+		WriteFloats(Blob, Component.Particles);
+		WriteFloats(Blob, Component.Velocities);
+		WriteFloats(Blob, Component.ShapeRotations);
+		WriteFloats(Blob, Component.ShapeTranslations);
+	}
+	return Blob;
+}
+
+bool DeserializeFlexCheckpoint(const uint8_t* Data, size_t Size, FFlexCheckpoint& OutCheckpoint)
+{
+	OutCheckpoint.Components.clear();
+	FBlobReader Reader(Data, Size);
+
+	char Magic[4];
+	uint32_t Version = 0;
+	uint32_t NumComponents = 0;
+	if (!Reader.ReadBytes(Magic, sizeof(Magic)) || std::memcmp(Magic, CheckpointMagic, sizeof(Magic)) != 0
+		|| !Reader.ReadUInt(Version) || Version != CheckpointVersion
+		|| !Reader.ReadUInt(NumComponents))
+	{
+		return false;
+	}
+
+	for (uint32_t c = 0; c < NumComponents; ++c)
+	{
+		FFlexCheckpointComponent Component;
+		uint32_t NameLength = 0;
+		uint32_t NumParticles = 0;
+		uint32_t NumShapes = 0;
+		if (!Reader.ReadUInt(NameLength) || NameLength > Size - Reader.Offset)
+		{
+			OutCheckpoint.Components.clear();
+			return false;
+		}
+		Component.Name.resize(NameLength);
+		if (!Reader.ReadBytes(&Component.Name[0], NameLength)
+			|| !Reader.ReadUInt(NumParticles) || !Reader.ReadUInt(NumShapes)
+			|| !Reader.ReadFloats(Component.Particles, size_t(NumParticles) * 4)
+			|| !Reader.ReadFloats(Component.Velocities, size_t(NumParticles) * 3)
+			|| !Reader.ReadFloats(Component.ShapeRotations, size_t(NumShapes) * 4)
+			|| !Reader.ReadFloats(Component.ShapeTranslations, size_t(NumShapes) * 3))
+		{
+			OutCheckpoint.Components.clear();
+			return false;
+		}
+		OutCheckpoint.Components.push_back(std::move(Component));
+	}
+	return Reader.Offset == Size;
+}
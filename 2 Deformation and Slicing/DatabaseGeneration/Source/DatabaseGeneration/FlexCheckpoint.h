@@ -0,0 +1,46 @@
+// Code by Marvin Kinz, m.kinz@stud.uni-heidelberg.de
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+* Simulation state of one Flex Component as plain float arrays copied out of its container, so the file format can be checked without Unreal by Tests/FlexCheckpointTest.cpp.
+*/
+struct FFlexCheckpointComponent
+{
+	//Identifies the component when restoring, e.g. actor name and component name
+	std::string Name;
+	//X Y Z InverseMass per particle
+	std::vector<float> Particles;
+	//X Y Z per particle
+	std::vector<float> Velocities;
+	//X Y Z W quaternion per cluster
+	std::vector<float> ShapeRotations;
+	//X Y Z per cluster
+	std::vector<float> ShapeTranslations;
+};
+
+/*
+* Simulation state of all Flex Components of one container
+*/
+struct FFlexCheckpoint
+{
+	std::vector<FFlexCheckpointComponent> Components;
+
+	//Component with the given name or nullptr
+	const FFlexCheckpointComponent* Find(const std::string& Name) const;
+};
+
+/*
+* Writes Checkpoint as binary blob: header "FXCP" and version, then per component name, particle and cluster count and the raw float arrays
+*/
+std::vector<uint8_t> SerializeFlexCheckpoint(const FFlexCheckpoint& Checkpoint);
+
+/*
+* Reads a blob written by SerializeFlexCheckpoint, returns false if it is truncated, has a different version or is no checkpoint at all
+*/
+bool DeserializeFlexCheckpoint(const uint8_t* Data, size_t Size, FFlexCheckpoint& OutCheckpoint);
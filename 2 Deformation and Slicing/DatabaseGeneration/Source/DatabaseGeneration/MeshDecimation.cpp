@@ -0,0 +1,443 @@
+// Code by Marvin Kinz, m.kinz@stud.uni-heidelberg.de
+
+#include "MeshDecimation.h"
+
+namespace
+{
+	//Weight of the planes put along open borders, high so borders are only collapsed along themselves
+	const double BoundaryWeight = 100.0;
+
+	//Symmetric 4x4 error quadric of Garland and Heckbert, only the upper triangle is stored
+	struct FQuadric
+	{
+		double A2 = 0.0, AB = 0.0, AC = 0.0, AD = 0.0;
+		double B2 = 0.0, BC = 0.0, BD = 0.0;
+		double C2 = 0.0, CD = 0.0;
+		double D2 = 0.0;
+		//Summed weight of the planes, to turn the summed squared distances into a mean
+		double Weight = 0.0;
+
+		FQuadric() {}
+
+		//Quadric of the plane ax + by + cz + d = 0 with (a,b,c) normalized, scaled by Weight
+		FQuadric(double A, double B, double C, double D, double Weight)
+			: A2(Weight * A * A), AB(Weight * A * B), AC(Weight * A * C), AD(Weight * A * D)
+			, B2(Weight * B * B), BC(Weight * B * C), BD(Weight * B * D)
+			, C2(Weight * C * C), CD(Weight * C * D)
+			, D2(Weight * D * D)
+			, Weight(Weight)
+		{}
+
+		FQuadric& operator+=(const FQuadric& Other)
+		{
+			A2 += Other.A2; AB += Other.AB; AC += Other.AC; AD += Other.AD;
+			B2 += Other.B2; BC += Other.BC; BD += Other.BD;
+			C2 += Other.C2; CD += Other.CD;
+			D2 += Other.D2;
+			Weight += Other.Weight;
+			return *this;
+		}
+
+		FQuadric operator+(const FQuadric& Other) const
+		{
+			FQuadric Result = *this;
+			Result += Other;
+			return Result;
+		}
+
+		//Sum of squared distances of P to all planes in this quadric
+		double Evaluate(const FVector& P) const
+		{
+			const double X = P.X, Y = P.Y, Z = P.Z;
+			return A2 * X * X + 2.0 * AB * X * Y + 2.0 * AC * X * Z + 2.0 * AD * X
+				+ B2 * Y * Y + 2.0 * BC * Y * Z + 2.0 * BD * Y
+				+ C2 * Z * Z + 2.0 * CD * Z
+				+ D2;
+		}
+
+		//Solves for the position with minimal error with Cramer's rule, false if the system is (nearly) singular
+		bool Minimize(FVector& OutPosition) const
+		{
+			const double Det = A2 * (B2 * C2 - BC * BC) - AB * (AB * C2 - BC * AC) + AC * (AB * BC - B2 * AC);
+			if (FMath::Abs(Det) < 1e-10)
+			{
+				return false;
+			}
+			const double RX = -AD, RY = -BD, RZ = -CD;
+			const double DX = RX * (B2 * C2 - BC * BC) - AB * (RY * C2 - BC * RZ) + AC * (RY * BC - B2 * RZ);
+			const double DY = A2 * (RY * C2 - BC * RZ) - RX * (AB * C2 - BC * AC) + AC * (AB * RZ - RY * AC);
+			const double DZ = A2 * (B2 * RZ - RY * BC) - AB * (AB * RZ - RY * AC) + RX * (AB * BC - B2 * AC);
+			OutPosition = FVector(DX / Det, DY / Det, DZ / Det);
+			return true;
+		}
+	};
+
+	//Candidate for collapsing V1 into V0, outdated as soon as one of the stamps does not match anymore
+	struct FCollapse
+	{
+		//Summed squared distance to all planes of both ends, orders the collapses
+		double Cost;
+		//Cost divided by the plane weight, i.e. the weighted mean squared distance, compared against MaxError
+		double Error;
+		int32 V0;
+		int32 V1;
+		uint32 Stamp0;
+		uint32 Stamp1;
+		FVector Position;
+	};
+
+	uint64 EdgeKey(int32 A, int32 B)
+	{
+		if (A > B)
+		{
+			Swap(A, B);
+		}
+		return (uint64(uint32(A)) << 32) | uint64(uint32(B));
+	}
+}
+
+bool FMeshDecimation::Decimate(const TArray<FVector>& Positions, const TArray<int32>& Indices, const FMeshDecimationSettings& Settings,
+	TArray<FVector>& OutPositions, TArray<int32>& OutIndices, TArray<int32>& OutOriginalVertices, TArray<int32>& OutCollapseMap, TArray<int32>& OutOriginalTriangles)
+{
+	OutPositions.Reset();
+	OutIndices.Reset();
+	OutOriginalVertices.Reset();
+	OutCollapseMap.Reset();
+	OutOriginalTriangles.Reset();
+
+	const int32 NumVertices = Positions.Num();
+	const int32 NumTriangles = Indices.Num() / 3;
+	if (!Settings.IsEnabled() || NumVertices == 0 || NumTriangles == 0)
+	{
+		return false;
+	}
+
+	//Working copies, collapsed vertices point to the vertex they have been merged into
+	TArray<FVector> Points = Positions;
+	TArray<int32> Triangles;
+	Triangles.Append(Indices.GetData(), NumTriangles * 3);
+	TArray<bool> TriangleRemoved;
+	TriangleRemoved.Init(false, NumTriangles);
+	TArray<int32> Parent;
+	Parent.SetNumUninitialized(NumVertices);
+	for (int32 v = 0; v < NumVertices; ++v)
+	{
+		Parent[v] = v;
+	}
+	TArray<uint32> Stamps;
+	Stamps.Init(0, NumVertices);
+	TArray<FQuadric> Quadrics;
+	Quadrics.SetNum(NumVertices);
+	TArray<TArray<int32>> VertexTriangles;
+	VertexTriangles.SetNum(NumVertices);
+
+	int32 LiveVertices = NumVertices;
+	int32 LiveTriangles = 0;
+
+	//Sum up the planes of all triangles at their corners, invalid triangles are dropped right away
+	for (int32 t = 0; t < NumTriangles; ++t)
+	{
+		const int32* Tri = &Triangles[t * 3];
+		if (Tri[0] < 0 || Tri[1] < 0 || Tri[2] < 0 || Tri[0] >= NumVertices || Tri[1] >= NumVertices || Tri[2] >= NumVertices
+			|| Tri[0] == Tri[1] || Tri[1] == Tri[2] || Tri[0] == Tri[2])
+		{
+			TriangleRemoved[t] = true;
+			continue;
+		}
+		FVector Normal = FVector::CrossProduct(Points[Tri[1]] - Points[Tri[0]], Points[Tri[2]] - Points[Tri[0]]);
+		//Triangles without area stay in the mesh, but do not define a plane
+		if (Normal.Normalize())
+		{
+			const FQuadric Plane(Normal.X, Normal.Y, Normal.Z, -FVector::DotProduct(Normal, Points[Tri[0]]), 1.0);
+			for (int32 k = 0; k < 3; ++k)
+			{
+				Quadrics[Tri[k]] += Plane;
+			}
+		}
+		for (int32 k = 0; k < 3; ++k)
+		{
+			VertexTriangles[Tri[k]].Add(t);
+		}
+		LiveTriangles++;
+	}
+
+	//Count the triangles on every edge to find open borders
+	TMap<uint64, int32> EdgeTriangles;
+	for (int32 t = 0; t < NumTriangles; ++t)
+	{
+		if (TriangleRemoved[t])
+		{
+			continue;
+		}
+		const int32* Tri = &Triangles[t * 3];
+		for (int32 k = 0; k < 3; ++k)
+		{
+			EdgeTriangles.FindOrAdd(EdgeKey(Tri[k], Tri[(k + 1) % 3]))++;
+		}
+	}
+
+	//Put a plane perpendicular to the triangle through every border edge, so the outline keeps its shape
+	for (int32 t = 0; t < NumTriangles; ++t)
+	{
+		if (TriangleRemoved[t])
+		{
+			continue;
+		}
+		const int32* Tri = &Triangles[t * 3];
+		const FVector Normal = FVector::CrossProduct(Points[Tri[1]] - Points[Tri[0]], Points[Tri[2]] - Points[Tri[0]]);
+		for (int32 k = 0; k < 3; ++k)
+		{
+			const int32 A = Tri[k];
+			const int32 B = Tri[(k + 1) % 3];
+			if (EdgeTriangles[EdgeKey(A, B)] != 1)
+			{
+				continue;
+			}
+			FVector Border = FVector::CrossProduct(Points[B] - Points[A], Normal);
+			if (Border.Normalize())
+			{
+				const FQuadric Plane(Border.X, Border.Y, Border.Z, -FVector::DotProduct(Border, Points[A]), BoundaryWeight);
+				Quadrics[A] += Plane;
+				Quadrics[B] += Plane;
+			}
+		}
+	}
+
+	//Evaluates the collapse of V1 into V0 at the optimal position
+	auto MakeCollapse = [&](int32 V0, int32 V1)
+	{
+		FCollapse Collapse;
+		Collapse.V0 = V0;
+		Collapse.V1 = V1;
+		Collapse.Stamp0 = Stamps[V0];
+		Collapse.Stamp1 = Stamps[V1];
+		const FQuadric Quadric = Quadrics[V0] + Quadrics[V1];
+		FVector Optimum;
+		if (Quadric.Minimize(Optimum))
+		{
+			Collapse.Position = Optimum;
+			Collapse.Cost = Quadric.Evaluate(Optimum);
+		}
+		else
+		{
+			//Flat or straight neighbourhood, take the best of both ends and the midpoint
+			const FVector Candidates[3] = { Points[V0], Points[V1], (Points[V0] + Points[V1]) * 0.5f };
+			Collapse.Cost = TNumericLimits<double>::Max();
+			for (const FVector& Candidate : Candidates)
+			{
+				const double Cost = Quadric.Evaluate(Candidate);
+				if (Cost < Collapse.Cost)
+				{
+					Collapse.Cost = Cost;
+					Collapse.Position = Candidate;
+				}
+			}
+		}
+		Collapse.Cost = FMath::Max(Collapse.Cost, 0.0);
+		Collapse.Error = Quadric.Weight > 0.0 ? Collapse.Cost / Quadric.Weight : 0.0;
+		return Collapse;
+	};
+
+	//Collects all vertices sharing a triangle with V
+	auto GatherNeighbours = [&](int32 V, TArray<int32>& OutNeighbours)
+	{
+		OutNeighbours.Reset();
+		for (int32 t : VertexTriangles[V])
+		{
+			if (TriangleRemoved[t])
+			{
+				continue;
+			}
+			for (int32 k = 0; k < 3; ++k)
+			{
+				if (Triangles[t * 3 + k] != V)
+				{
+					OutNeighbours.AddUnique(Triangles[t * 3 + k]);
+				}
+			}
+		}
+	};
+
+	//True if moving V to Position turns one of its triangles, that does not also contain Other, upside down
+	auto FlipsTriangle = [&](int32 V, int32 Other, const FVector& Position)
+	{
+		for (int32 t : VertexTriangles[V])
+		{
+			const int32* Tri = &Triangles[t * 3];
+			if (TriangleRemoved[t] || Tri[0] == Other || Tri[1] == Other || Tri[2] == Other)
+			{
+				continue;
+			}
+			FVector Moved[3];
+			for (int32 k = 0; k < 3; ++k)
+			{
+				Moved[k] = Tri[k] == V ? Position : Points[Tri[k]];
+			}
+			const FVector Before = FVector::CrossProduct(Points[Tri[1]] - Points[Tri[0]], Points[Tri[2]] - Points[Tri[0]]);
+			const FVector After = FVector::CrossProduct(Moved[1] - Moved[0], Moved[2] - Moved[0]);
+			if (FVector::DotProduct(Before, After) < 0.0f)
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	auto ReachedTarget = [&]()
+	{
+		return (Settings.TargetVertexCount > 0 && LiveVertices <= Settings.TargetVertexCount)
+			|| (Settings.TargetTriangleCount > 0 && LiveTriangles <= Settings.TargetTriangleCount);
+	};
+
+	auto CheaperFirst = [](const FCollapse& A, const FCollapse& B) { return A.Cost < B.Cost; };
+
+	TArray<FCollapse> Heap;
+	Heap.Reserve(EdgeTriangles.Num());
+	for (const TPair<uint64, int32>& Edge : EdgeTriangles)
+	{
+		Heap.Add(MakeCollapse(int32(Edge.Key >> 32), int32(Edge.Key & 0xffffffff)));
+	}
+	Heap.Heapify(CheaperFirst);
+
+	bool bCollapsed = false;
+	TArray<int32> Neighbours0;
+	TArray<int32> Neighbours1;
+	while (Heap.Num() > 0 && !ReachedTarget())
+	{
+		FCollapse Collapse;
+		Heap.HeapPop(Collapse, CheaperFirst, false);
+		const int32 V0 = Collapse.V0;
+		const int32 V1 = Collapse.V1;
+		//Skip candidates whose vertices have been changed since they were pushed
+		if (Parent[V0] != V0 || Parent[V1] != V1 || Stamps[V0] != Collapse.Stamp0 || Stamps[V1] != Collapse.Stamp1)
+		{
+			continue;
+		}
+		//Heap is sorted by summed cost, not by mean error, so cheaper collapses can still follow
+		if (Settings.MaxError > 0.0f && Collapse.Error > Settings.MaxError)
+		{
+			continue;
+		}
+
+		//Only collapse if the two ends share no other neighbours than the ones of the edge triangles, otherwise the mesh gets non-manifold
+		int32 EdgeTriangleCount = 0;
+		for (int32 t : VertexTriangles[V0])
+		{
+			const int32* Tri = &Triangles[t * 3];
+			if (!TriangleRemoved[t] && (Tri[0] == V1 || Tri[1] == V1 || Tri[2] == V1))
+			{
+				EdgeTriangleCount++;
+			}
+		}
+		if (EdgeTriangleCount == 0)
+		{
+			continue;
+		}
+		GatherNeighbours(V0, Neighbours0);
+		GatherNeighbours(V1, Neighbours1);
+		int32 SharedNeighbours = 0;
+		for (int32 n : Neighbours0)
+		{
+			if (Neighbours1.Contains(n))
+			{
+				SharedNeighbours++;
+			}
+		}
+		if (SharedNeighbours > EdgeTriangleCount)
+		{
+			continue;
+		}
+		if (FlipsTriangle(V0, V1, Collapse.Position) || FlipsTriangle(V1, V0, Collapse.Position))
+		{
+			continue;
+		}
+
+		//Collapse V1 into V0
+		Points[V0] = Collapse.Position;
+		Quadrics[V0] += Quadrics[V1];
+		for (int32 t : VertexTriangles[V1])
+		{
+			if (TriangleRemoved[t])
+			{
+				continue;
+			}
+			int32* Tri = &Triangles[t * 3];
+			if (Tri[0] == V0 || Tri[1] == V0 || Tri[2] == V0)
+			{
+				TriangleRemoved[t] = true;
+				LiveTriangles--;
+			}
+			else
+			{
+				for (int32 k = 0; k < 3; ++k)
+				{
+					if (Tri[k] == V1)
+					{
+						Tri[k] = V0;
+					}
+				}
+				VertexTriangles[V0].Add(t);
+			}
+		}
+		VertexTriangles[V1].Empty();
+		VertexTriangles[V0].RemoveAll([&](int32 t) { return TriangleRemoved[t]; });
+		Parent[V1] = V0;
+		Stamps[V0]++;
+		LiveVertices--;
+		bCollapsed = true;
+
+		//Reevaluate all edges around the merged vertex
+		GatherNeighbours(V0, Neighbours0);
+		for (int32 n : Neighbours0)
+		{
+			Heap.HeapPush(MakeCollapse(V0, n), CheaperFirst);
+		}
+	}
+
+	if (!bCollapsed)
+	{
+		return false;
+	}
+
+	//Compact the remaining vertices and remember where they came from
+	TArray<int32> NewIndices;
+	NewIndices.Init(INDEX_NONE, NumVertices);
+	OutPositions.Reserve(LiveVertices);
+	OutOriginalVertices.Reserve(LiveVertices);
+	for (int32 v = 0; v < NumVertices; ++v)
+	{
+		if (Parent[v] == v)
+		{
+			NewIndices[v] = OutPositions.Num();
+			OutPositions.Add(Points[v]);
+			OutOriginalVertices.Add(v);
+		}
+	}
+
+	//Follow the collapses of every original vertex to the vertex that survived
+	OutCollapseMap.SetNumUninitialized(NumVertices);
+	for (int32 v = 0; v < NumVertices; ++v)
+	{
+		int32 Root = v;
+		while (Parent[Root] != Root)
+		{
+			Root = Parent[Root];
+		}
+		Parent[v] = Root;
+		OutCollapseMap[v] = NewIndices[Root];
+	}
+
+	OutIndices.Reserve(LiveTriangles * 3);
+	OutOriginalTriangles.Reserve(LiveTriangles);
+	for (int32 t = 0; t < NumTriangles; ++t)
+	{
+		if (!TriangleRemoved[t])
+		{
+			OutIndices.Add(NewIndices[Triangles[t * 3]]);
+			OutIndices.Add(NewIndices[Triangles[t * 3 + 1]]);
+			OutIndices.Add(NewIndices[Triangles[t * 3 + 2]]);
+			OutOriginalTriangles.Add(t);
+		}
+	}
+	return true;
+}
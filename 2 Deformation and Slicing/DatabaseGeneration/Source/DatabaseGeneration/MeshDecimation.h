@@ -0,0 +1,42 @@
+// Code by Marvin Kinz, m.kinz@stud.uni-heidelberg.de
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Bounds for the decimation. Every bound that is 0 is ignored, decimation stops as soon as one of the set counts is reached or no collapse within MaxError is left.
+*/
+struct FMeshDecimationSettings
+{
+	//Stop when the mesh has at most this many vertices
+	int32 TargetVertexCount = 0;
+	//Stop when the mesh has at most this many triangles
+	int32 TargetTriangleCount = 0;
+	//Skip collapses whose position would be further than this from the original surface, measured as mean squared distance to the planes
+	//of all original triangles merged into the new vertex (planes along open borders weigh 100 times as much), so it is a squared distance in cm^2
+	float MaxError = 0.0f;
+
+	bool IsEnabled() const
+	{
+		return TargetVertexCount > 0 || TargetTriangleCount > 0 || MaxError > 0.0f;
+	}
+};
+
+/*
+* Quadric error edge collapse decimation after Garland and Heckbert, "Surface Simplification Using Quadric Error Metrics" (1997).
+* Only positions and connectivity are decimated, per corner attributes like UVs and normals are left to the caller, which keeps it independent of FRawMesh and safe to run per mesh on worker threads.
+*/
+class DATABASEGENERATION_API FMeshDecimation
+{
+public:
+	/*
+	* Decimates the triangle mesh given by Positions and Indices (3 per triangle).
+	* OutOriginalVertices holds for every decimated vertex the index of the original vertex it has been kept from,
+	* OutCollapseMap holds for every original vertex the index of the decimated vertex it has been merged into and
+	* OutOriginalTriangles holds for every decimated triangle the index of the original triangle it has been kept from.
+	* Returns false if nothing has been collapsed.
+	*/
+	static bool Decimate(const TArray<FVector>& Positions, const TArray<int32>& Indices, const FMeshDecimationSettings& Settings,
+		TArray<FVector>& OutPositions, TArray<int32>& OutIndices, TArray<int32>& OutOriginalVertices, TArray<int32>& OutCollapseMap, TArray<int32>& OutOriginalTriangles);
+};
@@ -0,0 +1,120 @@
+// Code by Marvin Kinz, m.kinz@stud.uni-heidelberg.de
+
+#include "MeshReordering.h"
+
+namespace
+{
+	//Bits per axis, 3 * 21 fit into 64 bit Morton codes
+	const uint32 MortonBits = 21;
+
+	//Spreads the lower 21 bits of Value, so that two zero bits are between each of them
+	uint64 SpreadBits(uint32 Value)
+	{
+		uint64 X = Value & 0x1fffff;
+		X = (X | X << 32) & 0x1f00000000ffffull;
+		X = (X | X << 16) & 0x1f0000ff0000ffull;
+		X = (X | X << 8) & 0x100f00f00f00f00full;
+		X = (X | X << 4) & 0x10c30c30c30c30c3ull;
+		X = (X | X << 2) & 0x1249249249249249ull;
+		return X;
+	}
+
+	//Quantizes positions in the bounding box and interleaves the bits of the three axes
+	struct FMortonEncoder
+	{
+		FVector Min;
+		FVector Scale;
+
+		explicit FMortonEncoder(const FBox& Bounds)
+			: Min(Bounds.Min)
+		{
+			const float MaxCell = float((1u << MortonBits) - 1);
+			const FVector Extent = Bounds.GetSize();
+			Scale = FVector(
+				Extent.X > SMALL_NUMBER ? MaxCell / Extent.X : 0.0f,
+				Extent.Y > SMALL_NUMBER ? MaxCell / Extent.Y : 0.0f,
+				Extent.Z > SMALL_NUMBER ? MaxCell / Extent.Z : 0.0f);
+		}
+
+		uint64 Encode(const FVector& P) const
+		{
+			const float MaxCell = float((1u << MortonBits) - 1);
+			const uint32 X = uint32(FMath::Clamp((P.X - Min.X) * Scale.X, 0.0f, MaxCell));
+			const uint32 Y = uint32(FMath::Clamp((P.Y - Min.Y) * Scale.Y, 0.0f, MaxCell));
+			const uint32 Z = uint32(FMath::Clamp((P.Z - Min.Z) * Scale.Z, 0.0f, MaxCell));
+			return SpreadBits(X) | (SpreadBits(Y) << 1) | (SpreadBits(Z) << 2);
+		}
+	};
+
+	//Sorts by code, equal codes keep their old order
+	void SortByCode(TArray<TPair<uint64, int32>>& Codes, TArray<int32>& OutOrder)
+	{
+		Codes.Sort([](const TPair<uint64, int32>& A, const TPair<uint64, int32>& B)
+		{
+			return A.Key < B.Key || (A.Key == B.Key && A.Value < B.Value);
+		});
+		OutOrder.Reset(Codes.Num());
+		for (const TPair<uint64, int32>& Code : Codes)
+		{
+			OutOrder.Add(Code.Value);
+		}
+	}
+}
+
+void FMeshReordering::MortonOrder(const TArray<FVector>& Positions, TArray<int32>& OutOrder)
+{
+	const FMortonEncoder Encoder(FBox(Positions));
+	TArray<TPair<uint64, int32>> Codes;
+	Codes.Reserve(Positions.Num());
+	for (int32 v = 0; v < Positions.Num(); ++v)
+	{
+		Codes.Add(TPair<uint64, int32>(Encoder.Encode(Positions[v]), v));
+	}
+	SortByCode(Codes, OutOrder);
+}
+
+void FMeshReordering::ReorderMesh(const TArray<FVector>& Positions, const TArray<int32>& Indices, TArray<int32>& OutVertexOrder, TArray<int32>& OutTriangleOrder, TArray<int32>& OutIndices)
+{
+	const int32 NumVertices = Positions.Num();
+	const int32 NumTriangles = Indices.Num() / 3;
+	const FMortonEncoder Encoder(FBox(Positions));
+
+	//Sort triangles by their centroids
+	TArray<TPair<uint64, int32>> Codes;
+	Codes.Reserve(NumTriangles);
+	for (int32 t = 0; t < NumTriangles; ++t)
+	{
+		const FVector Centroid = (Positions[Indices[t * 3]] + Positions[Indices[t * 3 + 1]] + Positions[Indices[t * 3 + 2]]) / 3.0f;
+		Codes.Add(TPair<uint64, int32>(Encoder.Encode(Centroid), t));
+	}
+	SortByCode(Codes, OutTriangleOrder);
+
+	//Number vertices in order of their first use by the sorted triangles
+	TArray<int32> NewIndices;
+	NewIndices.Init(INDEX_NONE, NumVertices);
+	OutVertexOrder.Reset(NumVertices);
+	OutIndices.Reset(NumTriangles * 3);
+	for (int32 Triangle : OutTriangleOrder)
+	{
+		for (int32 k = 0; k < 3; ++k)
+		{
+			const int32 Old = Indices[Triangle * 3 + k];
+			if (NewIndices[Old] == INDEX_NONE)
+			{
+				NewIndices[Old] = OutVertexOrder.Add(Old);
+			}
+			OutIndices.Add(NewIndices[Old]);
+		}
+	}
+
+	//Unused vertices go to the end, still sorted along the curve
+	TArray<int32> VertexOrder;
+	MortonOrder(Positions, VertexOrder);
+	for (int32 Old : VertexOrder)
+	{
+		if (NewIndices[Old] == INDEX_NONE)
+		{
+			NewIndices[Old] = OutVertexOrder.Add(Old);
+		}
+	}
+}
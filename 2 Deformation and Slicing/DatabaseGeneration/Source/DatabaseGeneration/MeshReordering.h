@@ -0,0 +1,25 @@
+// Code by Marvin Kinz, m.kinz@stud.uni-heidelberg.de
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Spatially coherent ordering of mesh vertices and triangles along a Morton (Z-order) curve, so that vertices close in space are close in memory.
+* Orders vertices and triangles of a surface mesh, or any other point set like the cluster centers of a Flex Soft Asset with MortonOrder. Flex particles keep their order.
+*/
+class DATABASEGENERATION_API FMeshReordering
+{
+public:
+	/*
+	* Sorts Positions along a Morton curve through their bounding box. OutOrder holds for every new index the old index.
+	*/
+	static void MortonOrder(const TArray<FVector>& Positions, TArray<int32>& OutOrder);
+
+	/*
+	* Sorts the triangles given by Indices (3 per triangle) by the Morton code of their centroids and numbers the vertices in order of their first use,
+	* so vertex buffers built from the triangles follow the curve as well. Vertices without triangle are appended in Morton order.
+	* OutVertexOrder holds for every new vertex the old index, OutTriangleOrder for every new triangle the old index and OutIndices the remapped triangles.
+	*/
+	static void ReorderMesh(const TArray<FVector>& Positions, const TArray<int32>& Indices, TArray<int32>& OutVertexOrder, TArray<int32>& OutTriangleOrder, TArray<int32>& OutIndices);
+};
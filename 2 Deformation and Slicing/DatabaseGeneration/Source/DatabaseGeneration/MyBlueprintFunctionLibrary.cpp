@@ -37,6 +37,21 @@
 //#include "Components/StaticMeshComponent.h"
 #include "Engine/StaticMesh.h"
 //#include "Materials/Material.h"
+//for decimation and reordering on import
+#include "MeshDecimation.h"
+#include "MeshReordering.h"
+#include "Async/ParallelFor.h"
+//for checkpoints
+#include "FlexCheckpoint.h"
+#include "Misc/FileHelper.h"
+#include "UObject/UObjectIterator.h"
+//for snapshot ring
+#include "SnapshotRing.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#endif
 
 //----------------------Storing-------------------------------------
 
@@ -71,6 +86,21 @@ void UMyBlueprintFunctionLibrary::WriteTriangleDataIntoFile(TArray<int> Triangle
 	return;
 }
 
+void UMyBlueprintFunctionLibrary::WriteIndexDataIntoFile(TArray<int> IndexData, FString OutputFolder, FString Filename, FString FileExtension)
+{
+	FString Directory = FPaths::ProjectDir();
+	FArchive *FileWriter = IFileManager::Get().CreateFileWriter(*Directory.Append(OutputFolder).Append("/").Append(Filename.Append(FileExtension)));
+	FString NewExcerpt;
+	for (int i = 0; i < IndexData.Num(); i++) {
+		NewExcerpt += FString::Printf(TEXT("%d"), IndexData[i]);
+		NewExcerpt += LINE_TERMINATOR;
+	}
+	FileWriter->Serialize(TCHAR_TO_ANSI(*NewExcerpt), NewExcerpt.Len());
+	FileWriter->Close();
+	delete FileWriter;
+	return;
+}
+
 void UMyBlueprintFunctionLibrary::SaveObject(FString OutputFolder, FString ActorLabel, UFlexComponent *FlexComponent) {
 	FString Directory = FPaths::ProjectDir();
 	FArchive *FileWriter = IFileManager::Get().CreateFileWriter(*Directory.Append(OutputFolder).Append("/").Append(ActorLabel.Append(".xyz")));// , EFileWrite::FILEWRITE_Append | EFileWrite::FILEWRITE_AllowRead | EFileWrite::FILEWRITE_EvenIfReadOnly);
@@ -87,6 +117,151 @@ void UMyBlueprintFunctionLibrary::SaveObject(FString OutputFolder, FString Actor
 	return;
 }
 
+namespace
+{
+	//Shared memory region of the snapshot ring, there is only one per editor
+#if PLATFORM_WINDOWS
+	//FPlatformMemory names regions "Global\<Name>" on Windows, which needs SeCreateGlobalPrivilege the editor usually does not have,
+	//so the mapping is created in the session namespace as "Local\<Name>", which is also what SnapshotConsumer.py opens
+	HANDLE SnapshotMapping = nullptr;
+	void* SnapshotAddress = nullptr;
+#else
+	//"/<Name>" with shm_open, i.e. /dev/shm/<Name> on Linux
+	FPlatformMemory::FSharedMemoryRegion* SnapshotRegion = nullptr;
+#endif
+	FSnapshotRing SnapshotRing;
+
+	//Creates a new region, an existing one is rejected instead of being reset under consumers that still read it
+	void* MapSnapshotRegion(const FString& Name, SIZE_T Size)
+	{
+#if PLATFORM_WINDOWS
+		const FString LocalName = FString(TEXT("Local\\")) + Name;
+		SnapshotMapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, DWORD(uint64(Size) >> 32), DWORD(uint64(Size) & 0xffffffff), *LocalName);
+		if (!SnapshotMapping) {
+			return nullptr;
+		}
+		if (GetLastError() == ERROR_ALREADY_EXISTS) {
+			UE_LOG(LogTemp, Warning, TEXT("Shared memory region %s already exists, close the consumers still holding it or use another name."), *LocalName);
+			CloseHandle(SnapshotMapping);
+			SnapshotMapping = nullptr;
+			return nullptr;
+		}
+		SnapshotAddress = MapViewOfFile(SnapshotMapping, FILE_MAP_ALL_ACCESS, 0, 0, Size);
+		if (!SnapshotAddress) {
+			CloseHandle(SnapshotMapping);
+			SnapshotMapping = nullptr;
+		}
+		return SnapshotAddress;
+#else
+#if PLATFORM_LINUX
+		if (IFileManager::Get().FileExists(*(FString(TEXT("/dev/shm/")) + Name))) {
+			UE_LOG(LogTemp, Warning, TEXT("Shared memory region /dev/shm/%s already exists, remove it or use another name."), *Name);
+			return nullptr;
+		}
+#endif
+		SnapshotRegion = FPlatformMemory::MapNamedSharedMemoryRegion(Name, true, FPlatformMemory::ESharedMemoryAccess::Read | FPlatformMemory::ESharedMemoryAccess::Write, Size);
+		return SnapshotRegion ? SnapshotRegion->GetAddress() : nullptr;
+#endif
+	}
+
+	void UnmapSnapshotRegion()
+	{
+#if PLATFORM_WINDOWS
+		if (SnapshotAddress) {
+			UnmapViewOfFile(SnapshotAddress);
+			SnapshotAddress = nullptr;
+		}
+		if (SnapshotMapping) {
+			CloseHandle(SnapshotMapping);
+			SnapshotMapping = nullptr;
+		}
+#else
+		if (SnapshotRegion) {
+			FPlatformMemory::UnmapNamedSharedMemoryRegion(SnapshotRegion);
+			SnapshotRegion = nullptr;
+		}
+#endif
+	}
+
+	static_assert(sizeof(FVector) == 3 * sizeof(float), "Snapshot ring expects tightly packed vectors");
+
+	//Warns if a publish function is called before OpenSnapshotRing
+	bool IsSnapshotRingOpen()
+	{
+		if (!SnapshotRing.IsValid()) {
+			UE_LOG(LogTemp, Warning, TEXT("Snapshot ring is not open, call OpenSnapshotRing first."));
+			return false;
+		}
+		return true;
+	}
+}
+
+bool UMyBlueprintFunctionLibrary::OpenSnapshotRing(FString Name, int NumSlots, int SlotSizeMB)
+{
+	CloseSnapshotRing();
+	if (NumSlots <= 0 || SlotSizeMB <= 0) {
+		UE_LOG(LogTemp, Warning, TEXT("Snapshot ring needs at least one slot of at least one MB."));
+		return false;
+	}
+	const SIZE_T Size = FSnapshotRing::RequiredSize(NumSlots, uint64(SlotSizeMB) * 1024 * 1024);
+	void* Memory = MapSnapshotRegion(Name, Size);
+	if (!Memory) {
+		UE_LOG(LogTemp, Warning, TEXT("Could not create shared memory region %s."), *Name);
+		return false;
+	}
+	if (!SnapshotRing.Initialize(Memory, Size, NumSlots)) {
+		UE_LOG(LogTemp, Warning, TEXT("Shared memory region %s is too small for the snapshot ring."), *Name);
+		CloseSnapshotRing();
+		return false;
+	}
+	return true;
+}
+
+void UMyBlueprintFunctionLibrary::CloseSnapshotRing()
+{
+	SnapshotRing.Detach();
+	UnmapSnapshotRegion();
+}
+
+bool UMyBlueprintFunctionLibrary::PublishSnapshot(FString Label, const TArray<FVector>& Vertices, const TArray<FVector>& Normals, const TArray<int>& Triangles)
+{
+	if (!IsSnapshotRingOpen()) {
+		return false;
+	}
+	if (!SnapshotRing.Publish(TCHAR_TO_UTF8(*Label), ESnapshotKind::Mesh, GFrameCounter, FApp::GetCurrentTime(), (const float*)Vertices.GetData(), Vertices.Num(), (const float*)Normals.GetData(), Normals.Num(), Triangles.GetData(), Triangles.Num())) {
+		UE_LOG(LogTemp, Warning, TEXT("%s does not fit into a slot of the snapshot ring."), *Label);
+		return false;
+	}
+	return true;
+}
+
+bool UMyBlueprintFunctionLibrary::PublishObject(FString Label, UFlexComponent *FlexComponent)
+{
+	if (!FlexComponent) {
+		UE_LOG(LogTemp, Warning, TEXT("No Flex Component passed, %s is not published."), *Label);
+		return false;
+	}
+	if (!IsSnapshotRingOpen()) {
+		return false;
+	}
+	const TArray<FVector4>& SimPositions = FlexComponent->SimPositions;
+	const TArray<FVector>& SimNormals = FlexComponent->SimNormals;
+	FSnapshotWriter Writer;
+	if (!SnapshotRing.BeginPublish(TCHAR_TO_UTF8(*Label), ESnapshotKind::Object, GFrameCounter, FApp::GetCurrentTime(), SimPositions.Num(), SimNormals.Num(), 0, Writer)) {
+		UE_LOG(LogTemp, Warning, TEXT("%s does not fit into a slot of the snapshot ring."), *Label);
+		return false;
+	}
+	//Simulation positions carry the inverse mass as W, which is stripped while writing straight into the slot
+	for (int i = 0; i < SimPositions.Num(); i++) {
+		Writer.Positions[i * 3] = SimPositions[i].X;
+		Writer.Positions[i * 3 + 1] = SimPositions[i].Y;
+		Writer.Positions[i * 3 + 2] = SimPositions[i].Z;
+	}
+	FMemory::Memcpy(Writer.Normals, SimNormals.GetData(), SimNormals.Num() * sizeof(FVector));
+	SnapshotRing.EndPublish();
+	return true;
+}
+
 //Taken from FlexRender.cpp 594 "UpdateSoftTransforms" and 285 "SkinSoft"
 
 void UMyBlueprintFunctionLibrary::Skin(UFlexComponent* FlexComponent, TArray<FVector> &Vertices, TArray<FVector> &Normals, TArray<FProcMeshTangent> &Tangents, FRotator &MeanRotation, FVector &MeanTranslation) {
@@ -203,6 +378,7 @@ void UMyBlueprintFunctionLibrary::Skin(UFlexComponent* FlexComponent, TArray<FVe
 	MeanTranslation = CompTrans.InverseTransformPosition(FVector(MX/maxIndice, MY/maxIndice, MZ/maxIndice));
 	
 }
+
 //-----------------Simulation------------------
 void UMyBlueprintFunctionLibrary::GetFlexSoftSettings(UFlexComponent* FlexComponent, float &ParticleSpacing, float &VolumeSampling, float &SurfaceSampling, float &ClusterSpacing, float &ClusterRadius, float &ClusterStiffness, UFlexContainer* &Container) {
 	UFlexAssetSoft* FAS = Cast<UFlexAssetSoft>(FlexComponent->GetFlexAsset());
@@ -220,7 +396,14 @@ void UMyBlueprintFunctionLibrary::GetFlexSoftSettings(UFlexComponent* FlexCompon
 	}
 }
 
-UFlexStaticMesh* UMyBlueprintFunctionLibrary::PMCtoFlex(UProceduralMeshComponent* ProcMesh, int Number, float ParticleSpacing, float VolumeSampling, float SurfaceSampling, float ClusterSpacing, float ClusterRadius, float ClusterStiffness, UFlexContainer* Container)
+namespace
+{
+	//Defined with the other raw mesh helpers in the Importing section
+	void ReorderRawMesh(FRawMesh& RawMesh, TArray<int32>& VertexOrder);
+	TArray<int32> MatchRenderVertices(const UStaticMesh* StaticMesh, const TArray<FVector>& OldPositions, const TArray<FVector>& OldNormals);
+}
+
+UFlexStaticMesh* UMyBlueprintFunctionLibrary::PMCtoFlex(UProceduralMeshComponent* ProcMesh, int Number, float ParticleSpacing, float VolumeSampling, float SurfaceSampling, float ClusterSpacing, float ClusterRadius, float ClusterStiffness, UFlexContainer* Container, bool bReorderVertices, FString VertexOrderFolder)
 {
 	// Find first selected ProcMeshComp
 	UProceduralMeshComponent* ProcMeshComp = ProcMesh;
@@ -324,6 +507,12 @@ UFlexStaticMesh* UMyBlueprintFunctionLibrary::PMCtoFlex(UProceduralMeshComponent
 				SrcModel->BuildSettings.bGenerateLightmapUVs = true;
 				SrcModel->BuildSettings.SrcLightmapIndex = 0;
 				SrcModel->BuildSettings.DstLightmapIndex = 1;
+				//Sort along a Morton curve, so skinning and storing run through memory in order
+				if (bReorderVertices)
+				{
+					TArray<int32> VertexOrder;
+					ReorderRawMesh(RawMesh, VertexOrder);
+				}
 				SrcModel->RawMeshBulkData->SaveRawMesh(RawMesh);
 
 
@@ -340,6 +529,27 @@ UFlexStaticMesh* UMyBlueprintFunctionLibrary::PMCtoFlex(UProceduralMeshComponent
 				// Build mesh from source
 				StaticMesh->Build(false);
 				StaticMesh->PostEditChange();
+				//Clusters along the same curve as the vertices, so skinning gathers them in order as well
+				if (bReorderVertices)
+				{
+					ReorderFlexClusters(StaticMesh, VertexOrderFolder);
+				}
+
+				// Store for every new vertex its index in the PMC
+				if (bReorderVertices && !VertexOrderFolder.IsEmpty())
+				{
+					TArray<FVector> ProcPositions;
+					TArray<FVector> ProcNormals;
+					for (int32 Idx = 0; Idx <= SectionIdx; Idx++)
+					{
+						for (FProcMeshVertex& Vert : ProcMeshComp->GetProcMeshSection(Idx)->ProcVertexBuffer)
+						{
+							ProcPositions.Add(Vert.Position);
+							ProcNormals.Add(Vert.Normal);
+						}
+					}
+					WriteIndexDataIntoFile(MatchRenderVertices(StaticMesh, ProcPositions, ProcNormals), VertexOrderFolder, AssetName, ".vertexorder");
+				}
 
 				// Notify asset registry of new asset
 				FAssetRegistryModule::AssetCreated(StaticMesh);
@@ -364,10 +574,509 @@ void UMyBlueprintFunctionLibrary::ReregisterFlexComponent(UFlexComponent * FlexC
 	FlexComponent->OnRegister();
 }
 
+bool UMyBlueprintFunctionLibrary::ReorderFlexClusters(UFlexStaticMesh* StaticMesh, FString ClusterOrderFolder)
+{
+	UFlexAssetSoft* FAS = StaticMesh ? Cast<UFlexAssetSoft>(StaticMesh->FlexAsset) : nullptr;
+	if (!FAS)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ReorderFlexClusters: passed mesh has no Flex Soft Asset."));
+		return false;
+	}
+	//Particles, clusters and skinning are sampled from the render data, so build them first where they do not exist yet
+	if (FAS->ShapeCenters.Num() == 0)
+	{
+		if (!StaticMesh->RenderData || StaticMesh->RenderData->LODResources.Num() == 0)
+		{
+			StaticMesh->Build(false);
+		}
+		FAS->ReImport(StaticMesh);
+	}
+	const int32 NumShapes = FAS->ShapeCenters.Num();
+	if (NumShapes == 0 || FAS->ShapeOffsets.Num() != NumShapes || FAS->ShapeIndices.Num() != FAS->ShapeOffsets.Last() || FAS->IndicesVertexBuffer.Vertices.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ReorderFlexClusters: %s has no clusters with skinning."), *StaticMesh->GetName());
+		return false;
+	}
+
+	TArray<int32> ClusterOrder;
+	FMeshReordering::MortonOrder(FAS->ShapeCenters, ClusterOrder);
+
+	//The render thread may still upload the skinning buffers of the last import
+	FlushRenderingCommands();
+
+	//Gather the clusters in the new order, the particle indices of every cluster stay together. Sizes do not change, so the arrays Flex points to stay valid
+	const TArray<FVector> Centers = FAS->ShapeCenters;
+	const TArray<int32> Indices = FAS->ShapeIndices;
+	const TArray<int32> Offsets = FAS->ShapeOffsets;
+	const TArray<float> Coefficients = FAS->ShapeCoefficients;
+	TArray<int32> NewIndices;
+	NewIndices.SetNumUninitialized(NumShapes);
+	int32 Offset = 0;
+	for (int32 New = 0; New < NumShapes; New++)
+	{
+		const int32 Old = ClusterOrder[New];
+		NewIndices[Old] = New;
+		FAS->ShapeCenters[New] = Centers[Old];
+		if (Coefficients.Num() == NumShapes)
+		{
+			FAS->ShapeCoefficients[New] = Coefficients[Old];
+		}
+		for (int32 k = Old > 0 ? Offsets[Old - 1] : 0; k < Offsets[Old]; k++)
+		{
+			FAS->ShapeIndices[Offset++] = Indices[k];
+		}
+		FAS->ShapeOffsets[New] = Offset;
+	}
+
+	//Skinning refers to the clusters by index, unused influences stay -1
+	for (int16& Cluster : FAS->IndicesVertexBuffer.Vertices)
+	{
+		if (Cluster > -1)
+		{
+			Cluster = int16(NewIndices[Cluster]);
+		}
+	}
+	BeginUpdateResourceRHI(&FAS->IndicesVertexBuffer);
+	FAS->MarkPackageDirty();
+
+	if (!ClusterOrderFolder.IsEmpty())
+	{
+		WriteIndexDataIntoFile(ClusterOrder, ClusterOrderFolder, StaticMesh->GetName(), ".clusterorder");
+	}
+	return true;
+}
+
+namespace
+{
+	//All Flex Components with an asset instance simulated in the same container as FlexComponent
+	TArray<UFlexComponent*> GetContainerComponents(UFlexComponent* FlexComponent)
+	{
+		TArray<UFlexComponent*> Components;
+		for (TObjectIterator<UFlexComponent> It; It; ++It) {
+			if (It->GetWorld() == FlexComponent->GetWorld() && It->ContainerInstance == FlexComponent->ContainerInstance && It->AssetInstance) {
+				Components.Add(*It);
+			}
+		}
+		return Components;
+	}
+
+	//Name to match components between runs, actor names stay the same for every run of the same level
+	std::string CheckpointName(UFlexComponent* FlexComponent)
+	{
+		FString Name = FlexComponent->GetOwner()->GetName() + "." + FlexComponent->GetName();
+		return std::string(TCHAR_TO_UTF8(*Name));
+	}
+
+	//Particles and velocities of the container are only valid while it is mapped between simulation steps
+	bool HasParticleData(UFlexComponent* FlexComponent)
+	{
+		if (!FlexComponent || !FlexComponent->ContainerInstance) {
+			UE_LOG(LogTemp, Warning, TEXT("Passed Flex Component is not simulated in a container."));
+			return false;
+		}
+		if (!FlexComponent->ContainerInstance->Particles || !FlexComponent->ContainerInstance->Velocities) {
+			UE_LOG(LogTemp, Warning, TEXT("Particle buffers of the Flex container are not mapped right now, call this between simulation steps."));
+			return false;
+		}
+		return true;
+	}
+
+	//Writes the cluster rotations and translations of State into the rigids of the container at Instance->shapeIndex.
+	//The instance copies are overwritten from the solver after every step and the solver starts shape matching from its own rotations,
+	//so the host copy of the container and the solver's rigid buffers are patched, the instance copies only for consistency until the next step
+	bool RestoreClusters(FFlexContainerInstance* Container, NvFlexExtInstance* Instance, const FFlexCheckpointComponent& State)
+	{
+		const int NumShapes = Instance->asset->numShapes;
+		const int First = Instance->shapeIndex;
+
+		NvFlexExtShapeData ShapeData = NvFlexExtMapShapeData(Container->Container);
+		const int NumRigids = ShapeData.n;
+		const bool bInRange = First >= 0 && First + NumShapes <= NumRigids;
+		if (bInRange) {
+			FMemory::Memcpy(ShapeData.rotations + First * 4, State.ShapeRotations.data(), NumShapes * 4 * sizeof(float));
+			FMemory::Memcpy(ShapeData.positions + First * 3, State.ShapeTranslations.data(), NumShapes * 3 * sizeof(float));
+		}
+		NvFlexExtUnmapShapeData(Container->Container);
+		if (!bInRange) {
+			return false;
+		}
+
+		//Get all rigids of the solver, patch the range of this instance and set them back, NvFlexSetRigids needs every buffer
+		NvFlexLibrary* Library = FFlexManager::get().GetFlexLib();
+		NvFlexVector<int> Offsets(Library, NumRigids + 1);
+		NvFlexGetRigids(Container->Solver, Offsets.buffer, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+		Offsets.map();
+		const int NumIndices = Offsets[NumRigids];
+		Offsets.unmap();
+
+		NvFlexVector<int> Indices(Library, NumIndices);
+		NvFlexVector<FVector> RestPositions(Library, NumIndices);
+		NvFlexVector<FVector4> RestNormals(Library, NumIndices);
+		NvFlexVector<float> Stiffness(Library, NumRigids);
+		NvFlexVector<float> Thresholds(Library, NumRigids);
+		NvFlexVector<float> Creeps(Library, NumRigids);
+		NvFlexVector<FQuat> Rotations(Library, NumRigids);
+		NvFlexVector<FVector> Translations(Library, NumRigids);
+		NvFlexGetRigids(Container->Solver, Offsets.buffer, Indices.buffer, RestPositions.buffer, RestNormals.buffer, Stiffness.buffer, Thresholds.buffer, Creeps.buffer, Rotations.buffer, Translations.buffer);
+
+		Rotations.map();
+		Translations.map();
+		FMemory::Memcpy(&Rotations[First], State.ShapeRotations.data(), NumShapes * 4 * sizeof(float));
+		FMemory::Memcpy(&Translations[First], State.ShapeTranslations.data(), NumShapes * 3 * sizeof(float));
+		Rotations.unmap();
+		Translations.unmap();
+		NvFlexSetRigids(Container->Solver, Offsets.buffer, Indices.buffer, RestPositions.buffer, RestNormals.buffer, Stiffness.buffer, Thresholds.buffer, Creeps.buffer, Rotations.buffer, Translations.buffer, NumRigids, NumIndices);
+
+		FMemory::Memcpy(Instance->shapeRotations, State.ShapeRotations.data(), NumShapes * 4 * sizeof(float));
+		FMemory::Memcpy(Instance->shapeTranslations, State.ShapeTranslations.data(), NumShapes * 3 * sizeof(float));
+		return true;
+	}
+}
+
+bool UMyBlueprintFunctionLibrary::SaveFlexCheckpoint(UFlexComponent* FlexComponent, FString OutputFolder, FString Filename)
+{
+	if (!HasParticleData(FlexComponent)) {
+		UE_LOG(LogTemp, Warning, TEXT("No checkpoint saved."));
+		return false;
+	}
+	FFlexContainerInstance* Container = FlexComponent->ContainerInstance;
+	FFlexCheckpoint Checkpoint;
+	for (UFlexComponent* Component : GetContainerComponents(FlexComponent)) {
+		const NvFlexExtInstance* Instance = Component->AssetInstance;
+		FFlexCheckpointComponent State;
+		State.Name = CheckpointName(Component);
+		//Gather particles of this component from the container
+		State.Particles.resize(Instance->numParticles * 4);
+		State.Velocities.resize(Instance->numParticles * 3);
+		for (int i = 0; i < Instance->numParticles; i++) {
+			const int Index = Instance->particleIndices[i];
+			const FVector4& Pos = Container->Particles[Index];
+			const FVector& Vel = Container->Velocities[Index];
+			State.Particles[i * 4] = Pos.X;
+			State.Particles[i * 4 + 1] = Pos.Y;
+			State.Particles[i * 4 + 2] = Pos.Z;
+			State.Particles[i * 4 + 3] = Pos.W;
+			State.Velocities[i * 3] = Vel.X;
+			State.Velocities[i * 3 + 1] = Vel.Y;
+			State.Velocities[i * 3 + 2] = Vel.Z;
+		}
+		//Clusters, only soft assets have them
+		const int NumShapes = Instance->shapeRotations ? Instance->asset->numShapes : 0;
+		if (NumShapes > 0) {
+			State.ShapeRotations.assign(Instance->shapeRotations, Instance->shapeRotations + NumShapes * 4);
+			State.ShapeTranslations.assign(Instance->shapeTranslations, Instance->shapeTranslations + NumShapes * 3);
+		}
+		Checkpoint.Components.push_back(std::move(State));
+	}
+
+	std::vector<uint8_t> Blob = SerializeFlexCheckpoint(Checkpoint);
+	TArray<uint8> Data(Blob.data(), Blob.size());
+	FString Directory = FPaths::ProjectDir();
+	if (!FFileHelper::SaveArrayToFile(Data, *Directory.Append(OutputFolder).Append("/").Append(Filename.Append(".checkpoint")))) {
+		UE_LOG(LogTemp, Warning, TEXT("Could not write checkpoint %s."), *Directory);
+		return false;
+	}
+	return true;
+}
+
+bool UMyBlueprintFunctionLibrary::LoadFlexCheckpoint(UFlexComponent* FlexComponent, FString InputFolder, FString Filename)
+{
+	if (!HasParticleData(FlexComponent)) {
+		UE_LOG(LogTemp, Warning, TEXT("No checkpoint loaded."));
+		return false;
+	}
+	FString Directory = FPaths::ProjectDir();
+	Directory.Append(InputFolder).Append("/").Append(Filename.Append(".checkpoint"));
+	TArray<uint8> Data;
+	FFlexCheckpoint Checkpoint;
+	if (!FFileHelper::LoadFileToArray(Data, *Directory) || !DeserializeFlexCheckpoint(Data.GetData(), Data.Num(), Checkpoint)) {
+		UE_LOG(LogTemp, Warning, TEXT("%s is no valid checkpoint."), *Directory);
+		return false;
+	}
+
+	FFlexContainerInstance* Container = FlexComponent->ContainerInstance;
+	bool bRestoredAll = true;
+	for (UFlexComponent* Component : GetContainerComponents(FlexComponent)) {
+		NvFlexExtInstance* Instance = Component->AssetInstance;
+		const FFlexCheckpointComponent* State = Checkpoint.Find(CheckpointName(Component));
+		const int NumShapes = Instance->shapeRotations ? Instance->asset->numShapes : 0;
+		//Only restore into the same asset, otherwise indices do not fit
+		if (!State || State->Particles.size() != size_t(Instance->numParticles) * 4 || State->ShapeRotations.size() != size_t(NumShapes) * 4) {
+			UE_LOG(LogTemp, Warning, TEXT("Checkpoint has no matching state for %s."), *Component->GetOwner()->GetName());
+			bRestoredAll = false;
+			continue;
+		}
+		//Scatter particles of this component back into the container
+		for (int i = 0; i < Instance->numParticles; i++) {
+			const int Index = Instance->particleIndices[i];
+			Container->Particles[Index] = FVector4(State->Particles[i * 4], State->Particles[i * 4 + 1], State->Particles[i * 4 + 2], State->Particles[i * 4 + 3]);
+			Container->Velocities[Index] = FVector(State->Velocities[i * 3], State->Velocities[i * 3 + 1], State->Velocities[i * 3 + 2]);
+		}
+		if (NumShapes > 0 && !RestoreClusters(Container, Instance, *State)) {
+			UE_LOG(LogTemp, Warning, TEXT("Clusters of %s are not part of the container's rigids, only its particles are restored."), *Component->GetOwner()->GetName());
+			bRestoredAll = false;
+		}
+	}
+	return bRestoredAll;
+}
+
 
 
 //-----------------Importing-------------------------
-void UMyBlueprintFunctionLibrary::ImportAssets(FString InputFolder, FString RootDestination) {
+namespace
+{
+	//Keeps the entries of the given triangles in the given order, PerTriangle is 3 for wedge and 1 for face data
+	template<typename T>
+	void KeepTriangleData(TArray<T>& Data, const TArray<int32>& Triangles, int32 PerTriangle)
+	{
+		if (Data.Num() == 0) {
+			return;
+		}
+		TArray<T> Kept;
+		Kept.Reserve(Triangles.Num() * PerTriangle);
+		for (int32 Triangle : Triangles) {
+			for (int32 k = 0; k < PerTriangle; ++k) {
+				Kept.Add(Data[Triangle * PerTriangle + k]);
+			}
+		}
+		Data = MoveTemp(Kept);
+	}
+
+	//Corners that were moved onto a surviving vertex still carry the UVs, color and tangents of their collapsed vertex,
+	//copy them from the corner of the survivor itself with the closest UV, so merged vertices do not split into several render vertices but UV seams stay
+	void UnifyMergedWedges(FRawMesh& RawMesh, const TArray<int32>& OldIndices, const TArray<int32>& OriginalVertices, const TArray<int32>& OriginalTriangles)
+	{
+		const int32 NumWedges = RawMesh.WedgeIndices.Num();
+		TMultiMap<int32, int32> OwnWedges;
+		TArray<bool> Own;
+		Own.Init(false, NumWedges);
+		for (int32 w = 0; w < NumWedges; ++w) {
+			const int32 Vertex = int32(RawMesh.WedgeIndices[w]);
+			if (OldIndices[OriginalTriangles[w / 3] * 3 + w % 3] == OriginalVertices[Vertex]) {
+				Own[w] = true;
+				OwnWedges.Add(Vertex, w);
+			}
+		}
+
+		const bool bHasUVs = RawMesh.WedgeTexCoords[0].Num() == NumWedges;
+		TArray<int32> Candidates;
+		for (int32 w = 0; w < NumWedges; ++w) {
+			if (Own[w]) {
+				continue;
+			}
+			Candidates.Reset();
+			OwnWedges.MultiFind(int32(RawMesh.WedgeIndices[w]), Candidates);
+			if (Candidates.Num() == 0) {
+				continue;
+			}
+			int32 Best = Candidates[0];
+			if (bHasUVs) {
+				for (int32 Candidate : Candidates) {
+					if (FVector2D::DistSquared(RawMesh.WedgeTexCoords[0][Candidate], RawMesh.WedgeTexCoords[0][w]) < FVector2D::DistSquared(RawMesh.WedgeTexCoords[0][Best], RawMesh.WedgeTexCoords[0][w])) {
+						Best = Candidate;
+					}
+				}
+			}
+			for (int32 UVIndex = 0; UVIndex < MAX_MESH_TEXTURE_COORDS; ++UVIndex) {
+				if (RawMesh.WedgeTexCoords[UVIndex].Num() == NumWedges) {
+					RawMesh.WedgeTexCoords[UVIndex][w] = RawMesh.WedgeTexCoords[UVIndex][Best];
+				}
+			}
+			if (RawMesh.WedgeColors.Num() == NumWedges) {
+				RawMesh.WedgeColors[w] = RawMesh.WedgeColors[Best];
+			}
+			if (RawMesh.WedgeTangentZ.Num() == NumWedges) {
+				RawMesh.WedgeTangentZ[w] = RawMesh.WedgeTangentZ[Best];
+			}
+			if (RawMesh.WedgeTangentX.Num() == NumWedges && RawMesh.WedgeTangentY.Num() == NumWedges) {
+				RawMesh.WedgeTangentX[w] = RawMesh.WedgeTangentX[Best];
+				RawMesh.WedgeTangentY[w] = RawMesh.WedgeTangentY[Best];
+			}
+		}
+	}
+
+	//Decimates RawMesh in place, wedges of the remaining triangles keep their UVs and colors, normals and tangents have to be recomputed by the build
+	bool DecimateRawMesh(FRawMesh& RawMesh, const FMeshDecimationSettings& Settings, TArray<int32>& OriginalVertices, TArray<int32>& CollapseMap)
+	{
+		TArray<int32> Indices;
+		Indices.Reserve(RawMesh.WedgeIndices.Num());
+		for (uint32 Index : RawMesh.WedgeIndices) {
+			Indices.Add(int32(Index));
+		}
+		TArray<FVector> Positions;
+		TArray<int32> DecimatedIndices;
+		TArray<int32> OriginalTriangles;
+		if (!FMeshDecimation::Decimate(RawMesh.VertexPositions, Indices, Settings, Positions, DecimatedIndices, OriginalVertices, CollapseMap, OriginalTriangles)) {
+			return false;
+		}
+
+		RawMesh.VertexPositions = MoveTemp(Positions);
+		RawMesh.WedgeIndices.Reset(DecimatedIndices.Num());
+		for (int32 Index : DecimatedIndices) {
+			RawMesh.WedgeIndices.Add(uint32(Index));
+		}
+		KeepTriangleData(RawMesh.WedgeTangentX, OriginalTriangles, 3);
+		KeepTriangleData(RawMesh.WedgeTangentY, OriginalTriangles, 3);
+		KeepTriangleData(RawMesh.WedgeTangentZ, OriginalTriangles, 3);
+		KeepTriangleData(RawMesh.WedgeColors, OriginalTriangles, 3);
+		for (int32 UVIndex = 0; UVIndex < MAX_MESH_TEXTURE_COORDS; ++UVIndex) {
+			KeepTriangleData(RawMesh.WedgeTexCoords[UVIndex], OriginalTriangles, 3);
+		}
+		KeepTriangleData(RawMesh.FaceMaterialIndices, OriginalTriangles, 1);
+		KeepTriangleData(RawMesh.FaceSmoothingMasks, OriginalTriangles, 1);
+		UnifyMergedWedges(RawMesh, Indices, OriginalVertices, OriginalTriangles);
+		return true;
+	}
+
+	//Sorts RawMesh in place along a Morton curve, render vertices follow the order of the sorted triangles. VertexOrder holds for every new vertex the old index
+	void ReorderRawMesh(FRawMesh& RawMesh, TArray<int32>& VertexOrder)
+	{
+		TArray<int32> Indices;
+		Indices.Reserve(RawMesh.WedgeIndices.Num());
+		for (uint32 Index : RawMesh.WedgeIndices) {
+			Indices.Add(int32(Index));
+		}
+		TArray<int32> TriangleOrder;
+		TArray<int32> ReorderedIndices;
+		FMeshReordering::ReorderMesh(RawMesh.VertexPositions, Indices, VertexOrder, TriangleOrder, ReorderedIndices);
+
+		TArray<FVector> Positions;
+		Positions.Reserve(VertexOrder.Num());
+		for (int32 Old : VertexOrder) {
+			Positions.Add(RawMesh.VertexPositions[Old]);
+		}
+		RawMesh.VertexPositions = MoveTemp(Positions);
+		RawMesh.WedgeIndices.Reset(ReorderedIndices.Num());
+		for (int32 Index : ReorderedIndices) {
+			RawMesh.WedgeIndices.Add(uint32(Index));
+		}
+		KeepTriangleData(RawMesh.WedgeTangentX, TriangleOrder, 3);
+		KeepTriangleData(RawMesh.WedgeTangentY, TriangleOrder, 3);
+		KeepTriangleData(RawMesh.WedgeTangentZ, TriangleOrder, 3);
+		KeepTriangleData(RawMesh.WedgeColors, TriangleOrder, 3);
+		for (int32 UVIndex = 0; UVIndex < MAX_MESH_TEXTURE_COORDS; ++UVIndex) {
+			KeepTriangleData(RawMesh.WedgeTexCoords[UVIndex], TriangleOrder, 3);
+		}
+		KeepTriangleData(RawMesh.FaceMaterialIndices, TriangleOrder, 1);
+		KeepTriangleData(RawMesh.FaceSmoothingMasks, TriangleOrder, 1);
+	}
+
+	//Renumbers the decimated vertices in the maps of DecimateRawMesh after ReorderRawMesh sorted them into VertexOrder
+	void ReorderDecimationMaps(const TArray<int32>& VertexOrder, TArray<int32>& OriginalVertices, TArray<int32>& CollapseMap)
+	{
+		TArray<int32> NewIndices;
+		NewIndices.SetNum(VertexOrder.Num());
+		TArray<int32> Reordered;
+		Reordered.Reserve(VertexOrder.Num());
+		for (int32 New = 0; New < VertexOrder.Num(); ++New) {
+			NewIndices[VertexOrder[New]] = New;
+			Reordered.Add(OriginalVertices[VertexOrder[New]]);
+		}
+		OriginalVertices = MoveTemp(Reordered);
+		for (int32& Decimated : CollapseMap) {
+			Decimated = NewIndices[Decimated];
+		}
+	}
+
+	//Copies positions and normals of the render vertices of StaticMesh
+	void GetRenderVertices(const UStaticMesh* StaticMesh, TArray<FVector>& OutPositions, TArray<FVector>& OutNormals)
+	{
+		const FPositionVertexBuffer& Positions = StaticMesh->RenderData->LODResources[0].VertexBuffers.PositionVertexBuffer;
+		const FStaticMeshVertexBuffer& StatVertices = StaticMesh->RenderData->LODResources[0].VertexBuffers.StaticMeshVertexBuffer;
+		const int NumVertices = Positions.GetNumVertices();
+		OutPositions.SetNum(NumVertices);
+		OutNormals.SetNum(NumVertices);
+		for (int VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex) {
+			OutPositions[VertexIndex] = Positions.VertexPosition(VertexIndex);
+			OutNormals[VertexIndex] = StatVertices.VertexTangentZ(VertexIndex);
+		}
+	}
+
+	//Finds for every render vertex of StaticMesh the old vertex at the same position with the closest normal, INDEX_NONE if there is none
+	TArray<int32> MatchRenderVertices(const UStaticMesh* StaticMesh, const TArray<FVector>& OldPositions, const TArray<FVector>& OldNormals)
+	{
+		TArray<FVector> Positions;
+		TArray<FVector> Normals;
+		GetRenderVertices(StaticMesh, Positions, Normals);
+
+		TMultiMap<FVector, int32> OldByPosition;
+		for (int32 i = 0; i < OldPositions.Num(); i++) {
+			OldByPosition.Add(OldPositions[i], i);
+		}
+		TArray<int32> Order;
+		Order.Init(INDEX_NONE, Positions.Num());
+		TArray<int32> Candidates;
+		int32 Unmatched = 0;
+		for (int32 v = 0; v < Positions.Num(); v++) {
+			Candidates.Reset();
+			OldByPosition.MultiFind(Positions[v], Candidates);
+			float BestDot = -MAX_flt;
+			for (int32 Candidate : Candidates) {
+				const float Dot = FVector::DotProduct(OldNormals[Candidate], Normals[v]);
+				if (Dot > BestDot) {
+					BestDot = Dot;
+					Order[v] = Candidate;
+				}
+			}
+			if (Order[v] == INDEX_NONE) {
+				Unmatched++;
+			}
+			else {
+				OldByPosition.RemoveSingle(Positions[v], Order[v]);
+			}
+		}
+		if (Unmatched > 0) {
+			UE_LOG(LogTemp, Warning, TEXT("%d vertices of %s have no counterpart in the original order."), Unmatched, *StaticMesh->GetName());
+		}
+		return Order;
+	}
+
+	//Finds for every render vertex the raw vertex at the same position, INDEX_NONE if there is none
+	TArray<int32> FindRawVertices(const TArray<FVector>& RenderPositions, const TArray<FVector>& RawPositions)
+	{
+		TMap<FVector, int32> RawByPosition;
+		for (int32 i = RawPositions.Num() - 1; i >= 0; i--) {
+			RawByPosition.Add(RawPositions[i], i);
+		}
+		TArray<int32> RawVertices;
+		RawVertices.Reserve(RenderPositions.Num());
+		for (const FVector& Position : RenderPositions) {
+			const int32* Raw = RawByPosition.Find(Position);
+			RawVertices.Add(Raw ? *Raw : INDEX_NONE);
+		}
+		return RawVertices;
+	}
+
+	//Translates RawMap between raw vertices into render vertices: render vertex v (raw vertex FromRaw[v]) gets the render vertex of raw vertex RawMap[FromRaw[v]] with the closest normal
+	TArray<int32> MapRenderVertices(const TArray<int32>& FromRaw, const TArray<FVector>& FromNormals, const TArray<int32>& RawMap, const TArray<int32>& ToRaw, const TArray<FVector>& ToNormals)
+	{
+		TMultiMap<int32, int32> ToByRaw;
+		for (int32 i = 0; i < ToRaw.Num(); i++) {
+			ToByRaw.Add(ToRaw[i], i);
+		}
+		TArray<int32> Map;
+		Map.Init(INDEX_NONE, FromRaw.Num());
+		TArray<int32> Candidates;
+		for (int32 v = 0; v < FromRaw.Num(); v++) {
+			if (!RawMap.IsValidIndex(FromRaw[v])) {
+				continue;
+			}
+			Candidates.Reset();
+			ToByRaw.MultiFind(RawMap[FromRaw[v]], Candidates);
+			float BestDot = -MAX_flt;
+			for (int32 Candidate : Candidates) {
+				const float Dot = FVector::DotProduct(ToNormals[Candidate], FromNormals[v]);
+				if (Dot > BestDot) {
+					BestDot = Dot;
+					Map[v] = Candidate;
+				}
+			}
+		}
+		return Map;
+	}
+}
+
+void UMyBlueprintFunctionLibrary::ImportAssets(FString InputFolder, FString RootDestination, int TargetVertexCount, int TargetTriangleCount, float MaxError, FString DecimationMapFolder, bool bReorderVertices) {
 	//FPaths::NormalizeDirectoryName(RootDestination);
 	TArray<FString> FoundFiles;
 	FString ext = ""; //could be used to filter for file extensions
@@ -393,6 +1102,9 @@ void UMyBlueprintFunctionLibrary::ImportAssets(FString InputFolder, FString Root
 		return;
 	}
 
+	//Import all objects as static meshes first, UObjects can only be created on the game thread
+	TArray<FString> FileNames;
+	TArray<UObject*> StaticMeshes;
 	for (auto &File : FoundFiles) {
 		FString FileName = FPaths::GetBaseFilename(File); //remove extension from file name
 		FileName.RemoveFromEnd("_mesh");
@@ -402,11 +1114,114 @@ void UMyBlueprintFunctionLibrary::ImportAssets(FString InputFolder, FString Root
 		FString PackageName = StaticFolder + FileName;
 		UPackage* Package = CreatePackage(nullptr, *PackageName);
 		UObject* StaticMesh = Factory->ImportObject(Factory->ResolveSupportedClass(), Package, *FileName, RF_Public | RF_Standalone | RF_Transactional, FileLocation, nullptr, bImportedCancelled);
+		if (!StaticMesh) {
+			UE_LOG(LogTemp, Warning, TEXT("Could not import %s."), *FileLocation);
+			continue;
+		}
+		FileNames.Add(FileName);
+		StaticMeshes.Add(StaticMesh);
+	}
+
+	//Decimate and reorder the source meshes before they are converted to Flex, only the work on the raw meshes runs in parallel
+	FMeshDecimationSettings DecimationSettings;
+	DecimationSettings.TargetVertexCount = TargetVertexCount;
+	DecimationSettings.TargetTriangleCount = TargetTriangleCount;
+	DecimationSettings.MaxError = MaxError;
+	if (DecimationSettings.IsEnabled() || bReorderVertices) {
+		const int32 NumMeshes = StaticMeshes.Num();
+		TArray<FRawMesh> RawMeshes;
+		RawMeshes.SetNum(NumMeshes);
+		TArray<bool> Loaded;
+		Loaded.Init(false, NumMeshes);
+
+		for (int32 i = 0; i < NumMeshes; i++) {
+			UStaticMesh* SM = Cast<UStaticMesh>(StaticMeshes[i]);
+			if (SM && SM->SourceModels.Num() > 0) {
+				SM->SourceModels[0].RawMeshBulkData->LoadRawMesh(RawMeshes[i]);
+				Loaded[i] = RawMeshes[i].VertexPositions.Num() > 0;
+			}
+		}
+
+		//Remember the render vertices in their imported order, outputs are written in render vertex order, so the maps have to be translated into it
+		TArray<TArray<FVector>> OldPositions;
+		OldPositions.SetNum(NumMeshes);
+		TArray<TArray<FVector>> OldNormals;
+		OldNormals.SetNum(NumMeshes);
+		for (int32 i = 0; i < NumMeshes; i++) {
+			if (Loaded[i]) {
+				GetRenderVertices(Cast<UStaticMesh>(StaticMeshes[i]), OldPositions[i], OldNormals[i]);
+			}
+		}
+
+		TArray<bool> Decimated;
+		Decimated.Init(false, NumMeshes);
+		TArray<TArray<int32>> OriginalVertices;
+		OriginalVertices.SetNum(NumMeshes);
+		TArray<TArray<int32>> CollapseMaps;
+		CollapseMaps.SetNum(NumMeshes);
+		TArray<TArray<int32>> VertexOrders;
+		VertexOrders.SetNum(NumMeshes);
+		TArray<TArray<FVector>> OldRawPositions;
+		OldRawPositions.SetNum(NumMeshes);
+
+		ParallelFor(NumMeshes, [&](int32 i) {
+			if (!Loaded[i]) {
+				return;
+			}
+			if (DecimationSettings.IsEnabled()) {
+				OldRawPositions[i] = RawMeshes[i].VertexPositions;
+				Decimated[i] = DecimateRawMesh(RawMeshes[i], DecimationSettings, OriginalVertices[i], CollapseMaps[i]);
+			}
+			if (bReorderVertices) {
+				ReorderRawMesh(RawMeshes[i], VertexOrders[i]);
+				if (Decimated[i]) {
+					ReorderDecimationMaps(VertexOrders[i], OriginalVertices[i], CollapseMaps[i]);
+				}
+			}
+		});
+
+		//Build every changed mesh once
+		for (int32 i = 0; i < NumMeshes; i++) {
+			if (!Decimated[i] && !(bReorderVertices && Loaded[i])) {
+				continue;
+			}
+			UStaticMesh* SM = Cast<UStaticMesh>(StaticMeshes[i]);
+			SM->SourceModels[0].RawMeshBulkData->SaveRawMesh(RawMeshes[i]);
+			if (Decimated[i]) {
+				//Imported normals and tangents belong to the full resolution surface
+				SM->SourceModels[0].BuildSettings.bRecomputeNormals = true;
+				SM->SourceModels[0].BuildSettings.bRecomputeTangents = true;
+			}
+			SM->Build(false);
+			SM->PostEditChange();
+			if (Decimated[i]) {
+				//Store correspondence to reconstruct the full resolution objects, already in the sorted vertex order
+				WriteIndexDataIntoFile(OriginalVertices[i], DecimationMapFolder, FileNames[i], ".vertexmap");
+				WriteIndexDataIntoFile(CollapseMaps[i], DecimationMapFolder, FileNames[i], ".collapsemap");
+				//Same maps between the render vertices of the decimated and the imported mesh
+				TArray<FVector> Positions;
+				TArray<FVector> Normals;
+				GetRenderVertices(SM, Positions, Normals);
+				const TArray<int32> OldRaw = FindRawVertices(OldPositions[i], OldRawPositions[i]);
+				const TArray<int32> NewRaw = FindRawVertices(Positions, RawMeshes[i].VertexPositions);
+				WriteIndexDataIntoFile(MapRenderVertices(NewRaw, Normals, OriginalVertices[i], OldRaw, OldNormals[i]), DecimationMapFolder, FileNames[i], ".rendervertexmap");
+				WriteIndexDataIntoFile(MapRenderVertices(OldRaw, OldNormals[i], CollapseMaps[i], NewRaw, Normals), DecimationMapFolder, FileNames[i], ".rendercollapsemap");
+				UE_LOG(LogTemp, Log, TEXT("Decimated %s from %d to %d vertices."), *FileNames[i], CollapseMaps[i].Num(), OriginalVertices[i].Num());
+			}
+			else if (bReorderVertices) {
+				//Store the order the vertices would have had, so outputs can be written in it when correspondence requires it
+				WriteIndexDataIntoFile(MatchRenderVertices(SM, OldPositions[i], OldNormals[i]), DecimationMapFolder, FileNames[i], ".vertexorder");
+			}
+		}
+	}
+
+	for (int32 i = 0; i < StaticMeshes.Num(); i++) {
+		FString& FileName = FileNames[i];
 		//Set name for Flex mesh and save a converted flex soft static mesh
 		//FString FileNameFlex = StaticMesh->GetName().Append("_Flex"); //leave this out, only clutters filename later. But if you want it change FileName to FileNameFlex three lines below
 		FString PackageNameFlex = FlexFolder + FileName;
 		UPackage* PackageFlex = CreatePackage(nullptr, *PackageNameFlex);
-		UFlexStaticMesh* FSM = Cast<UFlexStaticMesh>(StaticDuplicateObject(StaticMesh, PackageFlex, *FileName, RF_AllFlags, UFlexStaticMesh::StaticClass()));
+		UFlexStaticMesh* FSM = Cast<UFlexStaticMesh>(StaticDuplicateObject(StaticMeshes[i], PackageFlex, *FileName, RF_AllFlags, UFlexStaticMesh::StaticClass()));
 		UFlexAssetSoft* FAS = NewObject<UFlexAssetSoft>(FSM);
 		FSM->FlexAsset = FAS;
 		FSM->bAllowCPUAccess = 1;
@@ -30,6 +30,11 @@ public:
 	*/
 	UFUNCTION(BlueprintCallable, Category = "FlexParticleLibrary|Storing")
 		static void WriteTriangleDataIntoFile(TArray<int> TriangleData, FString OutputFolder, FString Filename, FString FileExtension = ".triangle");
+	/*
+	* Saves index array to file, one index per line
+	*/
+	UFUNCTION(BlueprintCallable, Category = "FlexParticleLibrary|Storing")
+		static void WriteIndexDataIntoFile(TArray<int> IndexData, FString OutputFolder, FString Filename, FString FileExtension = ".index");
 
 	/*
 	* Saves object (Flex Component simulation points) to file as .xyz with format X Y Z nx ny nz
@@ -41,6 +46,28 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "FlexParticleLibrary|Storing")
 		static void Skin(UFlexComponent *FlexComponent, TArray<FVector> &Vertices, TArray<FVector> &Normals, TArray<FProcMeshTangent> &Tangents, FRotator &MeanRotation, FVector &MeanTranslation);
 
+	/*
+	* Creates the shared memory ring buffer Name with NumSlots slots of SlotSizeMB megabytes each as optional output besides the files.
+	* Local consumers (e.g. SnapshotConsumer.py) can map it and read snapshots while the simulation keeps running
+	*/
+	UFUNCTION(BlueprintCallable, Category = "FlexParticleLibrary|Storing")
+		static bool OpenSnapshotRing(FString Name = "DatabaseGenerationSnapshots", int NumSlots = 16, int SlotSizeMB = 8);
+	/*
+	* Unmaps the snapshot ring buffer, consumers that still have it mapped keep their data
+	*/
+	UFUNCTION(BlueprintCallable, Category = "FlexParticleLibrary|Storing")
+		static void CloseSnapshotRing();
+	/*
+	* Publishes positions, normals and triangles (each may be empty) into the snapshot ring instead of writing files. Label is passed to the consumers, e.g. OutputFolder/Filename
+	*/
+	UFUNCTION(BlueprintCallable, Category = "FlexParticleLibrary|Storing")
+		static bool PublishSnapshot(FString Label, const TArray<FVector>& Vertices, const TArray<FVector>& Normals, const TArray<int>& Triangles);
+	/*
+	* Publishes object (Flex Component simulation points and normals) into the snapshot ring, counterpart of SaveObject
+	*/
+	UFUNCTION(BlueprintCallable, Category = "FlexParticleLibrary|Storing")
+		static bool PublishObject(FString Label, UFlexComponent *FlexComponent);
+
 	//----------------Simulation------------------------
 	/*
 	* Gets settings for Flex Soft Asset from Flex Component
@@ -50,22 +77,50 @@ public:
 
 	/*
 	* Converts PMC to Flex Static Mesh
+	* With bReorderVertices the vertices and triangles are sorted along a Morton curve for cache friendly skinning and the clusters with ReorderFlexClusters. If VertexOrderFolder is set, <asset name>.vertexorder
+	* with the index of the PMC vertex for every vertex of the new mesh and <asset name>.clusterorder are stored there, starting from the project folder as root, to write outputs in PMC order.
 	*/
 	UFUNCTION(BlueprintCallable, Category = "FlexParticleLibrary|Simulation")
-		static UFlexStaticMesh* PMCtoFlex(UProceduralMeshComponent* ProcMesh, int Number, float ParticleSpacing, float VolumeSampling, float SurfaceSampling, float ClusterSpacing, float ClusterRadius, float ClusterStiffness, UFlexContainer* Container);
+		static UFlexStaticMesh* PMCtoFlex(UProceduralMeshComponent* ProcMesh, int Number, float ParticleSpacing, float VolumeSampling, float SurfaceSampling, float ClusterSpacing, float ClusterRadius, float ClusterStiffness, UFlexContainer* Container, bool bReorderVertices = false, FString VertexOrderFolder = "");
 	/*
 	Reregister Flex Component
 	*/
 	UFUNCTION(BlueprintCallable, Category = "FlexParticleLibrary|Simulation")
 		static void ReregisterFlexComponent(UFlexComponent* FlexComponent);
+	/*
+	Sorts the clusters of the Flex Soft Asset of StaticMesh along a Morton curve through their centers and remaps the skinning indices, so Skin reads the cluster rotations and translations in order.
+	Builds the asset first if it has no clusters yet. If ClusterOrderFolder is set, <asset name>.clusterorder (index every cluster had before sorting) is stored there, starting from the project folder as root.
+	Rebuilding the asset, e.g. after changing its settings, restores the order of Flex, so call it again afterwards and reregister components that already use the asset. Returns false if there are no clusters to sort.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "FlexParticleLibrary|Simulation")
+		static bool ReorderFlexClusters(UFlexStaticMesh* StaticMesh, FString ClusterOrderFolder = "");
+	/*
+	Saves particle positions, velocities and cluster rotations and translations of all Flex Components in the container of FlexComponent as binary checkpoint to OutputFolder/Filename.checkpoint, starting from the project folder as root.
+	Call it between simulation steps, returns false if the particle buffers of the container are not mapped or the file could not be written.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "FlexParticleLibrary|Simulation")
+		static bool SaveFlexCheckpoint(UFlexComponent* FlexComponent, FString OutputFolder, FString Filename);
+	/*
+	Restores a checkpoint saved by SaveFlexCheckpoint into all Flex Components in the container of FlexComponent, components are matched by actor and component name.
+	Use this in a fresh run after the components have been registered to fork several simulations from the same state. Returns false if not every component could be restored.
+	Clusters are written into the rigids of the solver, so shape matching continues from the saved rotations instead of the ones of the fresh run.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "FlexParticleLibrary|Simulation")
+		static bool LoadFlexCheckpoint(UFlexComponent* FlexComponent, FString InputFolder, FString Filename);
 
 		
 	//-----------------Importing-------------------------
 	/*
 	Import Assets automated as Flex Soft Asset
+	Optionally decimates the meshes with quadric error edge collapses (in parallel across files) until TargetVertexCount, TargetTriangleCount or MaxError is reached, 0 disables the respective bound.
+	For every decimated mesh <name>.vertexmap (original vertex index of every decimated vertex) and <name>.collapsemap (decimated vertex index of every original vertex) are stored in DecimationMapFolder, starting from the project folder as root.
+	They index the raw source vertices (one per position). <name>.rendervertexmap and <name>.rendercollapsemap hold the same maps between render vertices, the numbering Skin and WriteVectorDataIntoFile write in.
+	With bReorderVertices the vertices and triangles are sorted along a Morton curve for cache friendly skinning. Decimation maps then use the sorted numbering, meshes that are only sorted get <name>.vertexorder (index every vertex had without reordering) in DecimationMapFolder instead.
+	The clusters are only created once the settings of the Flex Soft Assets are applied, sort them afterwards with ReorderFlexClusters.
+	Decimation and sorting run in the same parallel pass, every changed mesh is built once.
 	*/
 	UFUNCTION(BlueprintCallable, Category = "FlexParticleLibrary|Importing")
-		static void ImportAssets(FString InputFolder, FString RootDestination);
+		static void ImportAssets(FString InputFolder, FString RootDestination, int TargetVertexCount = 0, int TargetTriangleCount = 0, float MaxError = 0.0f, FString DecimationMapFolder = "DecimationMaps", bool bReorderVertices = false);
 	/*
 	*From Max
 	Place a StaticMesh or FlexStaticMesh in the current editor level with transform T
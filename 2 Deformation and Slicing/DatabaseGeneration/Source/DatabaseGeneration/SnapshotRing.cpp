@@ -0,0 +1,202 @@
+// Code by Marvin Kinz, m.kinz@stud.uni-heidelberg.de
+
+#include "SnapshotRing.h"
+#include <cstring>
+#include <new>
+
+namespace
+{
+	const char SnapshotRingMagic[4] = { 'F', 'X', 'S', 'R' };
+
+	size_t PayloadSize(uint32_t NumVertices, uint32_t NumNormals, uint32_t NumTriangleIndices)
+	{
+		return (size_t(NumVertices) * 3 + size_t(NumNormals) * 3) * sizeof(float) + size_t(NumTriangleIndices) * sizeof(int32_t);
+	}
+}
+
+size_t FSnapshotRing::RequiredSize(uint32_t NumSlots, uint64_t SlotPayload)
+{
+	//Keep slots on cache line boundaries
+	const uint64_t SlotSize = (sizeof(FSnapshotSlotHeader) + SlotPayload + 63) / 64 * 64;
+	return sizeof(FSnapshotRingHeader) + size_t(NumSlots) * SlotSize;
+}
+
+bool FSnapshotRing::Initialize(void* Memory, size_t Size, uint32_t NumSlots)
+{
+	Header = nullptr;
+	if (!Memory || NumSlots == 0 || Size < sizeof(FSnapshotRingHeader))
+	{
+		return false;
+	}
+	const uint64_t SlotSize = (Size - sizeof(FSnapshotRingHeader)) / NumSlots / 64 * 64;
+	if (SlotSize <= sizeof(FSnapshotSlotHeader))
+	{
+		return false;
+	}
+
+	FSnapshotRingHeader* NewHeader = new (Memory) FSnapshotRingHeader;
+	std::memset(NewHeader->Magic, 0, sizeof(NewHeader->Magic));
+	std::memset(NewHeader->Padding, 0, sizeof(NewHeader->Padding));
+	NewHeader->Version = SnapshotRingVersion;
+	NewHeader->NumSlots = NumSlots;
+	NewHeader->Reserved = 0;
+	NewHeader->SlotSize = SlotSize;
+	NewHeader->Published.store(0, std::memory_order_relaxed);
+	Header = NewHeader;
+	for (uint32_t s = 0; s < NumSlots; ++s)
+	{
+		FSnapshotSlotHeader* Slot = new (GetSlot(s)) FSnapshotSlotHeader;
+		Slot->Sequence.store(0, std::memory_order_relaxed);
+		Slot->NumVertices = 0;
+		Slot->NumNormals = 0;
+		Slot->NumTriangleIndices = 0;
+		Slot->Kind = uint32_t(ESnapshotKind::Mesh);
+		Slot->Frame = 0;
+		Slot->Time = 0.0;
+		Slot->Label[0] = '\0';
+	}
+	//Magic last, so consumers attaching early do not see a half set up ring
+	std::atomic_thread_fence(std::memory_order_release);
+	std::memcpy(NewHeader->Magic, SnapshotRingMagic, sizeof(SnapshotRingMagic));
+	return true;
+}
+
+bool FSnapshotRing::Attach(void* Memory, size_t Size)
+{
+	Header = nullptr;
+	if (!Memory || Size < sizeof(FSnapshotRingHeader))
+	{
+		return false;
+	}
+	FSnapshotRingHeader* Existing = static_cast<FSnapshotRingHeader*>(Memory);
+	if (std::memcmp(Existing->Magic, SnapshotRingMagic, sizeof(SnapshotRingMagic)) != 0 || Existing->Version != SnapshotRingVersion
+		|| Existing->NumSlots == 0 || Existing->SlotSize <= sizeof(FSnapshotSlotHeader)
+		|| sizeof(FSnapshotRingHeader) + Existing->NumSlots * Existing->SlotSize > Size)
+	{
+		return false;
+	}
+	Header = Existing;
+	return true;
+}
+
+void FSnapshotRing::Detach()
+{
+	Header = nullptr;
+}
+
+FSnapshotSlotHeader* FSnapshotRing::GetSlot(uint64_t Index) const
+{
+	uint8_t* Slots = reinterpret_cast<uint8_t*>(Header) + sizeof(FSnapshotRingHeader);
+	return reinterpret_cast<FSnapshotSlotHeader*>(Slots + (Index % Header->NumSlots) * Header->SlotSize);
+}
+
+bool FSnapshotRing::Publish(const char* Label, ESnapshotKind Kind, uint64_t Frame, double Time, const float* Positions, uint32_t NumVertices, const float* Normals, uint32_t NumNormals, const int32_t* Triangles, uint32_t NumTriangleIndices)
+{
+	FSnapshotWriter Writer;
+	if (!BeginPublish(Label, Kind, Frame, Time, NumVertices, NumNormals, NumTriangleIndices, Writer))
+	{
+		return false;
+	}
+	if (NumVertices > 0)
+	{
+		std::memcpy(Writer.Positions, Positions, size_t(NumVertices) * 3 * sizeof(float));
+	}
+	if (NumNormals > 0)
+	{
+		std::memcpy(Writer.Normals, Normals, size_t(NumNormals) * 3 * sizeof(float));
+	}
+	if (NumTriangleIndices > 0)
+	{
+		std::memcpy(Writer.Triangles, Triangles, size_t(NumTriangleIndices) * sizeof(int32_t));
+	}
+	EndPublish();
+	return true;
+}
+
+bool FSnapshotRing::BeginPublish(const char* Label, ESnapshotKind Kind, uint64_t Frame, double Time, uint32_t NumVertices, uint32_t NumNormals, uint32_t NumTriangleIndices, FSnapshotWriter& OutWriter)
+{
+	if (!Header || sizeof(FSnapshotSlotHeader) + PayloadSize(NumVertices, NumNormals, NumTriangleIndices) > Header->SlotSize)
+	{
+		return false;
+	}
+
+	//Only one producer, so nobody else changes the counter in between
+	const uint64_t Index = Header->Published.load(std::memory_order_relaxed);
+	FSnapshotSlotHeader* Slot = GetSlot(Index);
+	Slot->Sequence.store(2 * Index + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Slot->NumVertices = NumVertices;
+	Slot->NumNormals = NumNormals;
+	Slot->NumTriangleIndices = NumTriangleIndices;
+	Slot->Kind = uint32_t(Kind);
+	Slot->Frame = Frame;
+	Slot->Time = Time;
+	std::strncpy(Slot->Label, Label ? Label : "", sizeof(Slot->Label) - 1);
+	Slot->Label[sizeof(Slot->Label) - 1] = '\0';
+	uint8_t* Payload = reinterpret_cast<uint8_t*>(Slot) + sizeof(FSnapshotSlotHeader);
+	OutWriter.Positions = reinterpret_cast<float*>(Payload);
+	OutWriter.Normals = OutWriter.Positions + size_t(NumVertices) * 3;
+	OutWriter.Triangles = reinterpret_cast<int32_t*>(OutWriter.Normals + size_t(NumNormals) * 3);
+	return true;
+}
+
+void FSnapshotRing::EndPublish()
+{
+	const uint64_t Index = Header->Published.load(std::memory_order_relaxed);
+	GetSlot(Index)->Sequence.store(2 * Index + 2, std::memory_order_release);
+	Header->Published.store(Index + 1, std::memory_order_release);
+}
+
+uint64_t FSnapshotRing::NumPublished() const
+{
+	return Header ? Header->Published.load(std::memory_order_acquire) : 0;
+}
+
+bool FSnapshotRing::Read(uint64_t Index, FSnapshot& OutSnapshot) const
+{
+	if (!Header || Index >= NumPublished())
+	{
+		return false;
+	}
+	const FSnapshotSlotHeader* Slot = GetSlot(Index);
+	const uint64_t Expected = 2 * Index + 2;
+	if (Slot->Sequence.load(std::memory_order_acquire) != Expected)
+	{
+		return false;
+	}
+
+	//Counts could be torn by a concurrent overwrite, so check them against the slot before copying
+	const uint32_t NumVertices = Slot->NumVertices;
+	const uint32_t NumNormals = Slot->NumNormals;
+	const uint32_t NumTriangleIndices = Slot->NumTriangleIndices;
+	if (sizeof(FSnapshotSlotHeader) + PayloadSize(NumVertices, NumNormals, NumTriangleIndices) > Header->SlotSize)
+	{
+		return false;
+	}
+	const uint32_t Kind = Slot->Kind;
+	const uint64_t Frame = Slot->Frame;
+	const double Time = Slot->Time;
+	char Label[sizeof(Slot->Label)];
+	std::memcpy(Label, Slot->Label, sizeof(Label));
+	Label[sizeof(Label) - 1] = '\0';
+	const uint8_t* Payload = reinterpret_cast<const uint8_t*>(Slot) + sizeof(FSnapshotSlotHeader);
+	const float* Positions = reinterpret_cast<const float*>(Payload);
+	const float* Normals = Positions + size_t(NumVertices) * 3;
+	const int32_t* Triangles = reinterpret_cast<const int32_t*>(Normals + size_t(NumNormals) * 3);
+	OutSnapshot.Positions.assign(Positions, Positions + size_t(NumVertices) * 3);
+	OutSnapshot.Normals.assign(Normals, Normals + size_t(NumNormals) * 3);
+	OutSnapshot.Triangles.assign(Triangles, Triangles + NumTriangleIndices);
+
+	//Slot must not have been reused while copying
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (Slot->Sequence.load(std::memory_order_relaxed) != Expected)
+	{
+		return false;
+	}
+	OutSnapshot.Label = Label;
+	OutSnapshot.Kind = ESnapshotKind(Kind);
+	OutSnapshot.Frame = Frame;
+	OutSnapshot.Time = Time;
+	return true;
+}
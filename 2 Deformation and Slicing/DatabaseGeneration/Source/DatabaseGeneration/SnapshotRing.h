@@ -0,0 +1,120 @@
+// Code by Marvin Kinz, m.kinz@stud.uni-heidelberg.de
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Snapshot ring needs lock free 64 bit atomics to be shared between processes");
+
+/*
+* Memory layout of the snapshot ring, shared with the consumers (see SnapshotConsumer.py), so do not change it without raising SnapshotRingVersion.
+* The region starts with FSnapshotRingHeader, followed by NumSlots slots of SlotSize bytes. Every slot starts with FSnapshotSlotHeader,
+* followed by NumVertices * 3 floats positions, NumNormals * 3 floats normals and NumTriangleIndices int32 triangle indices.
+*/
+const uint32_t SnapshotRingVersion = 2;
+
+//What a slot holds, so consumers know which files to write
+enum class ESnapshotKind : uint32_t
+{
+	//Surface (PublishSnapshot), written as .xyz, .normals and .triangle
+	Mesh = 0,
+	//Simulation points and normals (PublishObject), written as one .xyz with six columns like SaveObject
+	Object = 1,
+};
+
+struct FSnapshotRingHeader
+{
+	//"FXSR"
+	char Magic[4];
+	uint32_t Version;
+	uint32_t NumSlots;
+	uint32_t Reserved;
+	//Bytes per slot including its header
+	uint64_t SlotSize;
+	//Number of snapshots published so far, snapshot n is in slot n % NumSlots
+	std::atomic<uint64_t> Published;
+	uint8_t Padding[32];
+};
+static_assert(sizeof(FSnapshotRingHeader) == 64, "Snapshot ring header layout changed");
+
+struct FSnapshotSlotHeader
+{
+	//2n+1 while snapshot n is written, 2n+2 once it is complete, consumers have to check it before and after reading
+	std::atomic<uint64_t> Sequence;
+	uint32_t NumVertices;
+	uint32_t NumNormals;
+	uint32_t NumTriangleIndices;
+	//ESnapshotKind
+	uint32_t Kind;
+	//Engine frame and application time the snapshot was published at
+	uint64_t Frame;
+	double Time;
+	//Zero terminated, e.g. OutputFolder/Filename without extension
+	char Label[216];
+};
+static_assert(sizeof(FSnapshotSlotHeader) == 256, "Snapshot slot header layout changed");
+
+/*
+* Snapshot copied out of the ring
+*/
+struct FSnapshot
+{
+	std::string Label;
+	ESnapshotKind Kind = ESnapshotKind::Mesh;
+	uint64_t Frame = 0;
+	double Time = 0.0;
+	std::vector<float> Positions;
+	std::vector<float> Normals;
+	std::vector<int32_t> Triangles;
+};
+
+/*
+* Where to write the data of the slot reserved by FSnapshotRing::BeginPublish, 3 floats per vertex for Positions and Normals
+*/
+struct FSnapshotWriter
+{
+	float* Positions = nullptr;
+	float* Normals = nullptr;
+	int32_t* Triangles = nullptr;
+};
+
+/*
+* Single producer ring buffer of mesh snapshots on top of a shared memory region. Publishing never waits for consumers,
+* slots are handed over with a sequence counter per slot, so a consumer that is too slow notices that its slot has been overwritten.
+* The ring does not map memory itself, OpenSnapshotRing hands it the named region and Tests/SnapshotRingTest.cpp plain heap memory.
+*/
+class FSnapshotRing
+{
+public:
+	//Bytes a region needs for NumSlots slots, that can each hold SlotPayload bytes of data
+	static size_t RequiredSize(uint32_t NumSlots, uint64_t SlotPayload);
+
+	//Sets up an empty ring in Memory, the producer calls this once after creating the region
+	bool Initialize(void* Memory, size_t Size, uint32_t NumSlots);
+	//Uses a ring already set up by Initialize, e.g. in a consumer
+	bool Attach(void* Memory, size_t Size);
+	void Detach();
+	bool IsValid() const { return Header != nullptr; }
+
+	//Copies the data into the next slot, returns false if it does not fit into a slot. Positions and Normals have 3 floats per vertex
+	bool Publish(const char* Label, ESnapshotKind Kind, uint64_t Frame, double Time, const float* Positions, uint32_t NumVertices, const float* Normals, uint32_t NumNormals, const int32_t* Triangles, uint32_t NumTriangleIndices);
+	//Reserves the next slot for the given counts, so the caller can write its data straight into the slot through OutWriter instead of copying it twice.
+	//Returns false if it does not fit into a slot, otherwise EndPublish has to be called once all data is written
+	bool BeginPublish(const char* Label, ESnapshotKind Kind, uint64_t Frame, double Time, uint32_t NumVertices, uint32_t NumNormals, uint32_t NumTriangleIndices, FSnapshotWriter& OutWriter);
+	//Hands the slot reserved by BeginPublish over to the consumers
+	void EndPublish();
+
+	//Number of snapshots published so far
+	uint64_t NumPublished() const;
+	//Copies snapshot Index, returns false if it has not been published yet or has already been overwritten
+	bool Read(uint64_t Index, FSnapshot& OutSnapshot) const;
+
+private:
+	FSnapshotSlotHeader* GetSlot(uint64_t Index) const;
+
+	FSnapshotRingHeader* Header = nullptr;
+};
@@ -0,0 +1,120 @@
+// Code by Marvin Kinz, m.kinz@stud.uni-heidelberg.de
+
+// Standalone round trip test of the checkpoint format, outside of Source so the Unreal Build Tool does not pick it up. Build and run from this folder with
+// g++ -std=c++14 -O2 -I../Source/DatabaseGeneration FlexCheckpointTest.cpp ../Source/DatabaseGeneration/FlexCheckpoint.cpp -o FlexCheckpointTest && ./FlexCheckpointTest
+
+#include "FlexCheckpoint.h"
+#include <cstdio>
+
+namespace
+{
+	int Failures = 0;
+
+	void Check(bool bCondition, const char* What)
+	{
+		if (!bCondition)
+		{
+			std::printf("FAILED: %s\n", What);
+			Failures++;
+		}
+	}
+
+	bool Equal(const FFlexCheckpointComponent& A, const FFlexCheckpointComponent& B)
+	{
+		return A.Name == B.Name && A.Particles == B.Particles && A.Velocities == B.Velocities
+			&& A.ShapeRotations == B.ShapeRotations && A.ShapeTranslations == B.ShapeTranslations;
+	}
+
+	//Soft object with clusters, cloth without and an empty component
+	FFlexCheckpoint MakeCheckpoint()
+	{
+		FFlexCheckpoint Checkpoint;
+		FFlexCheckpointComponent Soft;
+		Soft.Name = "FlexActor_0.FlexComponent0";
+		for (int i = 0; i < 5; i++)
+		{
+			Soft.Particles.insert(Soft.Particles.end(), { float(i), float(i) + 0.25f, -float(i), 1.0f / (i + 1) });
+			Soft.Velocities.insert(Soft.Velocities.end(), { 0.5f * i, -1.0f, 2.0f });
+		}
+		Soft.ShapeRotations = { 0, 0, 0, 1, 0.7071f, 0, 0, 0.7071f };
+		Soft.ShapeTranslations = { 1, 2, 3, -4, -5, -6 };
+		Checkpoint.Components.push_back(Soft);
+
+		FFlexCheckpointComponent Cloth;
+		Cloth.Name = "Cloth.FlexComponent0";
+		Cloth.Particles = { 1, 2, 3, 0 };
+		Cloth.Velocities = { 0, 0, -9.81f };
+		Checkpoint.Components.push_back(Cloth);
+
+		FFlexCheckpointComponent Empty;
+		Empty.Name = "Empty";
+		Checkpoint.Components.push_back(Empty);
+		return Checkpoint;
+	}
+
+	void TestRoundTrip()
+	{
+		const FFlexCheckpoint Checkpoint = MakeCheckpoint();
+		const std::vector<uint8_t> Blob = SerializeFlexCheckpoint(Checkpoint);
+		FFlexCheckpoint Restored;
+		Check(DeserializeFlexCheckpoint(Blob.data(), Blob.size(), Restored), "Deserialize serialized checkpoint");
+		Check(Restored.Components.size() == Checkpoint.Components.size(), "Component count");
+		for (size_t c = 0; c < Checkpoint.Components.size() && c < Restored.Components.size(); c++)
+		{
+			Check(Equal(Checkpoint.Components[c], Restored.Components[c]), "Component survives round trip");
+		}
+		Check(Restored.Find("Cloth.FlexComponent0") && Restored.Find("Cloth.FlexComponent0")->Velocities[2] == -9.81f, "Find component by name");
+		Check(!Restored.Find("Missing"), "Find missing component");
+
+		//Empty checkpoint
+		const std::vector<uint8_t> EmptyBlob = SerializeFlexCheckpoint(FFlexCheckpoint());
+		Check(DeserializeFlexCheckpoint(EmptyBlob.data(), EmptyBlob.size(), Restored) && Restored.Components.empty(), "Empty checkpoint");
+	}
+
+	void TestTruncatedAndCorrupt()
+	{
+		const std::vector<uint8_t> Blob = SerializeFlexCheckpoint(MakeCheckpoint());
+		FFlexCheckpoint Restored;
+		int Accepted = 0;
+		for (size_t Size = 0; Size < Blob.size(); Size++)
+		{
+			if (DeserializeFlexCheckpoint(Blob.data(), Size, Restored))
+			{
+				Accepted++;
+			}
+		}
+		Check(Accepted == 0, "Every truncation is rejected");
+
+		std::vector<uint8_t> Longer = Blob;
+		Longer.push_back(0);
+		Check(!DeserializeFlexCheckpoint(Longer.data(), Longer.size(), Restored), "Trailing bytes are rejected");
+
+		std::vector<uint8_t> WrongMagic = Blob;
+		WrongMagic[0] = 'X';
+		Check(!DeserializeFlexCheckpoint(WrongMagic.data(), WrongMagic.size(), Restored), "Wrong magic is rejected");
+
+		std::vector<uint8_t> WrongVersion = Blob;
+		WrongVersion[4]++;
+		Check(!DeserializeFlexCheckpoint(WrongVersion.data(), WrongVersion.size(), Restored), "Other version is rejected");
+
+		//Name length pointing far beyond the blob
+		std::vector<uint8_t> HugeName = Blob;
+		HugeName[12] = HugeName[13] = HugeName[14] = HugeName[15] = 0xff;
+		Check(!DeserializeFlexCheckpoint(HugeName.data(), HugeName.size(), Restored), "Oversized name is rejected");
+
+		Check(!DeserializeFlexCheckpoint(nullptr, 0, Restored), "No data is rejected");
+	}
+}
+
+int main()
+{
+	TestRoundTrip();
+	TestTruncatedAndCorrupt();
+	if (Failures > 0)
+	{
+		std::printf("%d checks failed\n", Failures);
+		return 1;
+	}
+	std::printf("All checkpoint checks passed\n");
+	return 0;
+}
@@ -0,0 +1,291 @@
+// Code by Marvin Kinz, m.kinz@stud.uni-heidelberg.de
+
+// Standalone benchmark of the gather loop of Skin for different vertex and cluster orders, outside of Source so the Unreal Build Tool does not pick it up. Build and run from this folder with
+// g++ -std=c++14 -O2 SkinOrderBenchmark.cpp -o SkinOrderBenchmark && ./SkinOrderBenchmark
+// The Morton curve is the one of FMeshReordering, skinning follows Flex (four closest clusters, weights falling off with distance).
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct FVec
+	{
+		float X, Y, Z;
+	};
+
+	FVec operator+(const FVec& A, const FVec& B) { return { A.X + B.X, A.Y + B.Y, A.Z + B.Z }; }
+	FVec operator-(const FVec& A, const FVec& B) { return { A.X - B.X, A.Y - B.Y, A.Z - B.Z }; }
+	FVec operator*(const FVec& A, float S) { return { A.X * S, A.Y * S, A.Z * S }; }
+	FVec Cross(const FVec& A, const FVec& B) { return { A.Y * B.Z - A.Z * B.Y, A.Z * B.X - A.X * B.Z, A.X * B.Y - A.Y * B.X }; }
+	float DistSquared(const FVec& A, const FVec& B) { const FVec D = A - B; return D.X * D.X + D.Y * D.Y + D.Z * D.Z; }
+
+	//Same rotation as FQuat::RotateVector
+	FVec Rotate(const float* Q, const FVec& V)
+	{
+		const FVec Axis = { Q[0], Q[1], Q[2] };
+		const FVec T = Cross(Axis, V) * 2.0f;
+		return V + T * Q[3] + Cross(Axis, T);
+	}
+
+	//Normals and tangents are packed into 8 bit per component like in FStaticMeshVertexBuffer
+	struct FPacked
+	{
+		int8_t X, Y, Z, W;
+	};
+
+	FPacked Pack(const FVec& V) { return { int8_t(V.X * 127.0f), int8_t(V.Y * 127.0f), int8_t(V.Z * 127.0f), 127 }; }
+	FVec Unpack(const FPacked& P) { return { P.X / 127.0f, P.Y / 127.0f, P.Z / 127.0f }; }
+
+	uint64_t SpreadBits(uint32_t Value)
+	{
+		uint64_t X = Value & 0x1fffff;
+		X = (X | X << 32) & 0x1f00000000ffffull;
+		X = (X | X << 16) & 0x1f0000ff0000ffull;
+		X = (X | X << 8) & 0x100f00f00f00f00full;
+		X = (X | X << 4) & 0x10c30c30c30c30c3ull;
+		X = (X | X << 2) & 0x1249249249249249ull;
+		return X;
+	}
+
+	//Old index for every new index along the Morton curve through the bounding box of Points
+	std::vector<int> MortonOrder(const std::vector<FVec>& Points)
+	{
+		FVec Min = Points[0];
+		FVec Max = Points[0];
+		for (const FVec& P : Points)
+		{
+			Min = { std::min(Min.X, P.X), std::min(Min.Y, P.Y), std::min(Min.Z, P.Z) };
+			Max = { std::max(Max.X, P.X), std::max(Max.Y, P.Y), std::max(Max.Z, P.Z) };
+		}
+		const float MaxCell = float((1u << 21) - 1);
+		const FVec Size = Max - Min;
+		std::vector<std::pair<uint64_t, int>> Codes;
+		for (int i = 0; i < int(Points.size()); i++)
+		{
+			const FVec Q = Points[i] - Min;
+			const uint32_t X = uint32_t(Size.X > 0 ? Q.X / Size.X * MaxCell : 0);
+			const uint32_t Y = uint32_t(Size.Y > 0 ? Q.Y / Size.Y * MaxCell : 0);
+			const uint32_t Z = uint32_t(Size.Z > 0 ? Q.Z / Size.Z * MaxCell : 0);
+			Codes.push_back({ SpreadBits(X) | (SpreadBits(Y) << 1) | (SpreadBits(Z) << 2), i });
+		}
+		std::sort(Codes.begin(), Codes.end());
+		std::vector<int> Order;
+		for (const auto& Code : Codes)
+		{
+			Order.push_back(Code.second);
+		}
+		return Order;
+	}
+
+	std::vector<int> Shuffled(int Num, std::mt19937& Random)
+	{
+		std::vector<int> Order(Num);
+		std::iota(Order.begin(), Order.end(), 0);
+		std::shuffle(Order.begin(), Order.end(), Random);
+		return Order;
+	}
+
+	//What Skin reads: render vertex buffers, skinning of the soft asset and cluster state of the instance
+	struct FSkinData
+	{
+		std::vector<FVec> Positions;
+		std::vector<FPacked> TangentsX;
+		std::vector<FPacked> TangentsZ;
+		std::vector<int16_t> ClusterIndices;
+		std::vector<float> ClusterWeights;
+		std::vector<FVec> RestPoses;
+		std::vector<float> Rotations;
+		std::vector<float> Translations;
+	};
+
+	//Surface of a bumpy sphere as vertices, written ring after ring like a generator would, and clusters inside of it
+	FSkinData MakeObject(int Rings, int NumClusters, std::mt19937& Random)
+	{
+		FSkinData Data;
+		const float Pi = 3.14159265f;
+		for (int r = 0; r < Rings; r++)
+		{
+			const float Theta = Pi * (r + 0.5f) / Rings;
+			for (int s = 0; s < 2 * Rings; s++)
+			{
+				const float Phi = Pi * s / Rings;
+				const FVec N = { std::sin(Theta) * std::cos(Phi), std::sin(Theta) * std::sin(Phi), std::cos(Theta) };
+				const float Radius = 50.0f + 5.0f * std::sin(5 * Theta) * std::cos(3 * Phi);
+				Data.Positions.push_back(N * Radius);
+				Data.TangentsZ.push_back(Pack(N));
+				Data.TangentsX.push_back(Pack({ -std::sin(Phi), std::cos(Phi), 0.0f }));
+			}
+		}
+
+		//Flex samples particles on a voxel grid and builds clusters while running through it, so clusters come in scanline order
+		std::uniform_real_distribution<float> Uniform(-1.0f, 1.0f);
+		while (int(Data.RestPoses.size()) < NumClusters)
+		{
+			const FVec P = { Uniform(Random), Uniform(Random), Uniform(Random) };
+			if (DistSquared(P, { 0, 0, 0 }) < 1.0f)
+			{
+				Data.RestPoses.push_back(P * 52.0f);
+			}
+		}
+		std::sort(Data.RestPoses.begin(), Data.RestPoses.end(), [](const FVec& A, const FVec& B)
+		{
+			const int AZ = int(A.Z / 10), BZ = int(B.Z / 10), AY = int(A.Y / 10), BY = int(B.Y / 10);
+			return AZ != BZ ? AZ < BZ : AY != BY ? AY < BY : A.X < B.X;
+		});
+
+		for (const FVec& P : Data.Positions)
+		{
+			std::vector<std::pair<float, int>> Closest;
+			for (int c = 0; c < NumClusters; c++)
+			{
+				Closest.push_back({ DistSquared(P, Data.RestPoses[c]), c });
+			}
+			std::partial_sort(Closest.begin(), Closest.begin() + 4, Closest.end());
+			float Sum = 0.0f;
+			for (int w = 0; w < 4; w++)
+			{
+				Sum += 1.0f / (Closest[w].first + 1.0f);
+			}
+			for (int w = 0; w < 4; w++)
+			{
+				Data.ClusterIndices.push_back(int16_t(Closest[w].second));
+				Data.ClusterWeights.push_back(1.0f / (Closest[w].first + 1.0f) / Sum);
+			}
+		}
+
+		std::normal_distribution<float> Normal(0.0f, 0.1f);
+		for (int c = 0; c < NumClusters; c++)
+		{
+			float Q[4] = { Normal(Random), Normal(Random), Normal(Random), 1.0f };
+			const float Length = std::sqrt(Q[0] * Q[0] + Q[1] * Q[1] + Q[2] * Q[2] + Q[3] * Q[3]);
+			for (float& Value : Q)
+			{
+				Data.Rotations.push_back(Value / Length);
+			}
+			const FVec T = Data.RestPoses[c] + FVec{ Normal(Random), Normal(Random), Normal(Random) - 5.0f };
+			Data.Translations.insert(Data.Translations.end(), { T.X, T.Y, T.Z });
+		}
+		return Data;
+	}
+
+	//New order of vertices and clusters, both given as old index for every new index, like the vertex order of ReorderMesh and the cluster order of ReorderFlexClusters
+	FSkinData Reorder(const FSkinData& In, const std::vector<int>& VertexOrder, const std::vector<int>& ClusterOrder)
+	{
+		FSkinData Out;
+		std::vector<int> NewCluster(ClusterOrder.size());
+		for (int New = 0; New < int(ClusterOrder.size()); New++)
+		{
+			const int Old = ClusterOrder[New];
+			NewCluster[Old] = New;
+			Out.RestPoses.push_back(In.RestPoses[Old]);
+			Out.Rotations.insert(Out.Rotations.end(), In.Rotations.begin() + Old * 4, In.Rotations.begin() + Old * 4 + 4);
+			Out.Translations.insert(Out.Translations.end(), In.Translations.begin() + Old * 3, In.Translations.begin() + Old * 3 + 3);
+		}
+		for (int Old : VertexOrder)
+		{
+			Out.Positions.push_back(In.Positions[Old]);
+			Out.TangentsX.push_back(In.TangentsX[Old]);
+			Out.TangentsZ.push_back(In.TangentsZ[Old]);
+			for (int w = 0; w < 4; w++)
+			{
+				const int Cluster = In.ClusterIndices[Old * 4 + w];
+				Out.ClusterIndices.push_back(int16_t(Cluster > -1 ? NewCluster[Cluster] : -1));
+				Out.ClusterWeights.push_back(In.ClusterWeights[Old * 4 + w]);
+			}
+		}
+		return Out;
+	}
+
+	//Loop body of Skin
+	void Skin(const FSkinData& Data, std::vector<FVec>& Vertices, std::vector<FVec>& Normals, std::vector<FVec>& Tangents)
+	{
+		const int NumVertices = int(Data.Positions.size());
+		for (int VertexIndex = 0; VertexIndex < NumVertices; ++VertexIndex)
+		{
+			FVec SoftPos = { 0, 0, 0 };
+			FVec SoftNormal = { 0, 0, 0 };
+			FVec SoftTangent = { 0, 0, 0 };
+			for (int w = 0; w < 4; ++w)
+			{
+				const int Cluster = Data.ClusterIndices[VertexIndex * 4 + w];
+				const float Weight = Data.ClusterWeights[VertexIndex * 4 + w];
+				if (Cluster > -1)
+				{
+					const float* Rotation = &Data.Rotations[Cluster * 4];
+					const FVec Translation = { Data.Translations[Cluster * 3], Data.Translations[Cluster * 3 + 1], Data.Translations[Cluster * 3 + 2] };
+					SoftPos = SoftPos + (Rotate(Rotation, Data.Positions[VertexIndex] - Data.RestPoses[Cluster]) + Translation) * Weight;
+					SoftNormal = SoftNormal + Rotate(Rotation, Unpack(Data.TangentsZ[VertexIndex])) * Weight;
+					SoftTangent = SoftTangent + Rotate(Rotation, Unpack(Data.TangentsX[VertexIndex])) * Weight;
+				}
+			}
+			Vertices[VertexIndex] = SoftPos;
+			Normals[VertexIndex] = SoftNormal;
+			Tangents[VertexIndex] = SoftTangent;
+		}
+	}
+
+	//Median time of one Skin call in microseconds
+	double TimeSkin(const FSkinData& Data, int Repetitions)
+	{
+		std::vector<FVec> Vertices(Data.Positions.size());
+		std::vector<FVec> Normals(Data.Positions.size());
+		std::vector<FVec> Tangents(Data.Positions.size());
+		std::vector<double> Times;
+		for (int i = 0; i < Repetitions; i++)
+		{
+			const auto Start = std::chrono::steady_clock::now();
+			Skin(Data, Vertices, Normals, Tangents);
+			Times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - Start).count());
+		}
+		std::sort(Times.begin(), Times.end());
+		volatile float Sink = Vertices[Data.Positions.size() / 2].X;
+		(void)Sink;
+		return Times[Times.size() / 2];
+	}
+
+	void Run(int Rings, int NumClusters, int Repetitions)
+	{
+		std::mt19937 Random(Rings * 7919 + NumClusters);
+		const FSkinData Object = MakeObject(Rings, NumClusters, Random);
+		const int NumVertices = int(Object.Positions.size());
+		std::vector<int> Identity(NumVertices);
+		std::iota(Identity.begin(), Identity.end(), 0);
+		std::vector<int> Clusters(NumClusters);
+		std::iota(Clusters.begin(), Clusters.end(), 0);
+		const std::vector<int> RandomVertices = Shuffled(NumVertices, Random);
+		const std::vector<int> RandomClusters = Shuffled(NumClusters, Random);
+		const std::vector<int> MortonVertices = MortonOrder(Object.Positions);
+		const std::vector<int> MortonClusters = MortonOrder(Object.RestPoses);
+
+		std::printf("%d vertices, %d clusters\n", NumVertices, NumClusters);
+		std::printf("  vertices   clusters    us per Skin\n");
+		const struct { const char* Vertices; const std::vector<int>* VertexOrder; const char* Clusters; const std::vector<int>* ClusterOrder; } Cases[] = {
+			{ "generated", &Identity, "Flex", &Clusters },
+			{ "shuffled", &RandomVertices, "Flex", &Clusters },
+			{ "shuffled", &RandomVertices, "shuffled", &RandomClusters },
+			{ "Morton", &MortonVertices, "Flex", &Clusters },
+			{ "Morton", &MortonVertices, "shuffled", &RandomClusters },
+			{ "Morton", &MortonVertices, "Morton", &MortonClusters },
+		};
+		for (const auto& Case : Cases)
+		{
+			const FSkinData Data = Reorder(Object, *Case.VertexOrder, *Case.ClusterOrder);
+			std::printf("  %-10s %-10s %10.0f\n", Case.Vertices, Case.Clusters, TimeSkin(Data, Repetitions));
+		}
+	}
+}
+
+int main()
+{
+	Run(64, 300, 101);
+	Run(200, 2000, 31);
+	Run(300, 8000, 11);
+	return 0;
+}
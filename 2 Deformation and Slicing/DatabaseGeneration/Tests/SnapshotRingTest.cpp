@@ -0,0 +1,161 @@
+// Code by Marvin Kinz, m.kinz@stud.uni-heidelberg.de
+
+// Standalone test of the snapshot ring, outside of Source so the Unreal Build Tool does not pick it up. Build and run from this folder with
+// g++ -std=c++14 -O2 -pthread -I../Source/DatabaseGeneration SnapshotRingTest.cpp ../Source/DatabaseGeneration/SnapshotRing.cpp -o SnapshotRingTest && ./SnapshotRingTest
+
+#include "SnapshotRing.h"
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+	int Failures = 0;
+
+	void Check(bool bCondition, const char* What)
+	{
+		if (!bCondition)
+		{
+			std::printf("FAILED: %s\n", What);
+			Failures++;
+		}
+	}
+
+	//Heap memory instead of a named region, aligned for the atomics
+	struct FRegion
+	{
+		std::vector<uint64_t> Words;
+		explicit FRegion(size_t Size) : Words((Size + 7) / 8, 0) {}
+		void* Memory() { return Words.data(); }
+		size_t Size() const { return Words.size() * 8; }
+	};
+
+	void TestPublishAndRead()
+	{
+		FRegion Region(FSnapshotRing::RequiredSize(4, 1024));
+		FSnapshotRing Producer;
+		Check(Producer.Initialize(Region.Memory(), Region.Size(), 4), "Initialize");
+		FSnapshotRing Consumer;
+		Check(Consumer.Attach(Region.Memory(), Region.Size()), "Attach to initialized ring");
+
+		FSnapshot Snapshot;
+		Check(!Consumer.Read(0, Snapshot), "Read before anything is published");
+
+		const float Positions[6] = { 1, 2, 3, 4, 5, 6 };
+		const float Normals[6] = { 0, 0, 1, 0, 1, 0 };
+		const int32_t Triangles[3] = { 0, 1, 1 };
+		Check(Producer.Publish("Out/Mesh", ESnapshotKind::Mesh, 7, 0.5, Positions, 2, Normals, 2, Triangles, 3), "Publish mesh");
+		Check(Consumer.NumPublished() == 1, "Published count after Publish");
+		Check(Consumer.Read(0, Snapshot), "Read mesh");
+		Check(Snapshot.Label == "Out/Mesh" && Snapshot.Kind == ESnapshotKind::Mesh && Snapshot.Frame == 7 && Snapshot.Time == 0.5, "Mesh metadata");
+		Check(Snapshot.Positions == std::vector<float>(Positions, Positions + 6), "Mesh positions");
+		Check(Snapshot.Normals == std::vector<float>(Normals, Normals + 6), "Mesh normals");
+		Check(Snapshot.Triangles == std::vector<int32_t>(Triangles, Triangles + 3), "Mesh triangles");
+
+		//Written in place like PublishObject does
+		FSnapshotWriter Writer;
+		Check(Producer.BeginPublish("Out/Object", ESnapshotKind::Object, 8, 1.5, 2, 2, 0, Writer), "BeginPublish object");
+		Check(!Consumer.Read(1, Snapshot), "Read while the slot is written");
+		std::memcpy(Writer.Positions, Positions, sizeof(Positions));
+		std::memcpy(Writer.Normals, Normals, sizeof(Normals));
+		Producer.EndPublish();
+		Check(Consumer.Read(1, Snapshot), "Read object");
+		Check(Snapshot.Label == "Out/Object" && Snapshot.Kind == ESnapshotKind::Object && Snapshot.Frame == 8 && Snapshot.Time == 1.5, "Object metadata");
+		Check(Snapshot.Positions == std::vector<float>(Positions, Positions + 6) && Snapshot.Triangles.empty(), "Object data");
+
+		//Too large for a slot
+		std::vector<float> Large(3 * 1024);
+		Check(!Producer.Publish("Out/Large", ESnapshotKind::Mesh, 9, 2.0, Large.data(), 1024, nullptr, 0, nullptr, 0), "Publish larger than a slot");
+		Check(Consumer.NumPublished() == 2, "Published count after rejected snapshot");
+
+		//Snapshot 0 is overwritten once the ring has wrapped around
+		for (int i = 0; i < 4; i++)
+		{
+			Check(Producer.Publish("Out/Wrap", ESnapshotKind::Mesh, 10 + i, 0.0, Positions, 2, nullptr, 0, nullptr, 0), "Publish to wrap around");
+		}
+		Check(!Consumer.Read(0, Snapshot), "Read overwritten snapshot");
+		Check(Consumer.Read(5, Snapshot) && Snapshot.Frame == 13, "Read newest snapshot");
+	}
+
+	void TestAttachRejects()
+	{
+		FRegion Region(FSnapshotRing::RequiredSize(2, 256));
+		FSnapshotRing Consumer;
+		Check(!Consumer.Attach(Region.Memory(), Region.Size()), "Attach to memory without ring");
+		FSnapshotRing Producer;
+		Check(Producer.Initialize(Region.Memory(), Region.Size(), 2), "Initialize small ring");
+		Check(!Consumer.Attach(Region.Memory(), sizeof(FSnapshotRingHeader)), "Attach with a region smaller than the ring");
+		Check(Consumer.Attach(Region.Memory(), Region.Size()), "Attach to small ring");
+		Consumer.Detach();
+		Check(!Consumer.IsValid(), "Detach");
+	}
+
+	//Consumer on a second thread must only ever see complete snapshots, every value of snapshot n is n
+	void TestConcurrentRead()
+	{
+		const uint32_t NumValues = 3 * 256;
+		const uint64_t NumSnapshots = 20000;
+		FRegion Region(FSnapshotRing::RequiredSize(4, NumValues * sizeof(float)));
+		FSnapshotRing Producer;
+		Check(Producer.Initialize(Region.Memory(), Region.Size(), 4), "Initialize concurrent ring");
+		FSnapshotRing Consumer;
+		Check(Consumer.Attach(Region.Memory(), Region.Size()), "Attach concurrent ring");
+
+		int Torn = 0;
+		uint64_t Complete = 0;
+		std::thread Reader([&]()
+		{
+			FSnapshot Snapshot;
+			uint64_t Next = 0;
+			while (Next < NumSnapshots)
+			{
+				const uint64_t Published = Consumer.NumPublished();
+				if (Next >= Published)
+				{
+					continue;
+				}
+				if (Consumer.Read(Next, Snapshot))
+				{
+					Complete++;
+					for (float Value : Snapshot.Positions)
+					{
+						if (Value != float(Snapshot.Frame) || Snapshot.Frame != Next)
+						{
+							Torn++;
+							break;
+						}
+					}
+				}
+				Next++;
+			}
+		});
+
+		for (uint64_t n = 0; n < NumSnapshots; n++)
+		{
+			FSnapshotWriter Writer;
+			Producer.BeginPublish("Out/Concurrent", ESnapshotKind::Object, n, 0.0, NumValues / 3, 0, 0, Writer);
+			for (uint32_t v = 0; v < NumValues; v++)
+			{
+				Writer.Positions[v] = float(n);
+			}
+			Producer.EndPublish();
+		}
+		Reader.join();
+		Check(Torn == 0, "No torn snapshots");
+		Check(Complete > 0, "Consumer read some snapshots");
+	}
+}
+
+int main()
+{
+	TestPublishAndRead();
+	TestAttachRejects();
+	TestConcurrentRead();
+	if (Failures > 0)
+	{
+		std::printf("%d checks failed\n", Failures);
+		return 1;
+	}
+	std::printf("All snapshot ring checks passed\n");
+	return 0;
+}